@@ -21,6 +21,7 @@
 // @author Stephane Rochon
 
 #include "mbed.h"
+#include <stdarg.h>
 #ifndef _uLCD
 #define _uLCD 0
 // Debug Verbose off - SGE commands echoed to USB serial for debugmode=1
@@ -31,6 +32,32 @@
 // Common WAIT value in milliseconds between commands
 #define TEMPO 0
 
+// Goldelox UART input buffer in bytes.  Long commands are paced a chunk at a
+// time, waiting TX_CHUNK_WAIT_US for the display to drain each chunk, rather
+// than waiting after every byte.
+#ifndef TX_CHUNK
+#define TX_CHUNK 16
+#endif
+#ifndef TX_CHUNK_WAIT_US
+#define TX_CHUNK_WAIT_US 500
+#endif
+
+// Milliseconds to wait for a command's answer.  A screen that doesn't answer
+// in time is marked offline and skipped until probe() finds it again.
+#ifndef ACK_TIMEOUT_MS
+#define ACK_TIMEOUT_MS 500
+#endif
+
+// Opcodes tracked by the command statistics, the last slot collects the rest
+#ifndef CMD_STATS
+#define CMD_STATS 24
+#endif
+
+// Longest printf output sent as one string command, longer output is truncated
+#ifndef PRINTF_BUFFER
+#define PRINTF_BUFFER 64
+#endif
+
 // 4DGL SGE Function values for Goldelox Processor
 #define CLS          '\xD7'
 #define BAUDRATE     '\x0B' //null prefix
@@ -76,6 +103,9 @@
 #define DISPLAYIMAGE '\xB3'
 #define DISPLAYVIDEO '\xBB'
 #define DISPLAYFRAME '\xBA'
+#define READSECTOR   '\x16' //null prefix
+#define WRITESECTOR  '\x17' //null prefix
+#define SECTOR_SIZE  512
 
 
 
@@ -203,7 +233,15 @@ class uLCD_4DGL : public Stream
 
 public :
 
-    uLCD_4DGL(PinName tx, PinName rx, PinName rst);
+    /** Create a uLCD_4DGL
+    * @param tx, rx, rst Serial and reset pins
+    * @param init Reset and clear the screen now, which takes over 3 seconds.
+    * Pass false to call init() later, e.g. from a background thread.
+    */
+    uLCD_4DGL(PinName tx, PinName rx, PinName rst, bool init = true);
+
+    /** Reset the screen, clear it and select the default font */
+    void init();
 
 // General Commands *******************************************************************************
 
@@ -259,6 +297,14 @@ public :
     int  read_pixel(int, int);
     void pen_size(char);
     void BLIT(int x, int y, int w, int h, int *colors);
+    /** Draw a block of pixels already in the screen's RGB565 format, see tools/rgb565_asset.py
+    * @param colors w*h RGB565 pixels
+    */
+    void BLIT(int x, int y, int w, int h, const uint16_t *colors);
+    /** Draw a block of run length encoded RGB565 pixels, see tools/rgb565_asset.py --rle
+    * @param runs (count, RGB565 color) pairs covering w*h pixels
+    */
+    void BLIT_RLE(int x, int y, int w, int h, const uint16_t *runs);
 
 // Text Commands
     void set_font(char);
@@ -275,7 +321,13 @@ public :
     void locate(char, char);
     void color(int);
     void putc(char);
-    void puts(char *);
+    void puts(const char *);
+
+    /** Print formatted text at the cursor.  Each run of printable characters
+    * goes out as one string command rather than a command per character.
+    * @param format printf style format
+    */
+    int printf(const char *format, ...);
 
 //Media Commands
     int media_init();
@@ -286,6 +338,16 @@ public :
     void write_byte(int);
     void write_word(int);
     void flush_media();
+    /** Read SECTOR_SIZE bytes from the sector address set by set_sector_address()
+    * @param data buffer of SECTOR_SIZE bytes
+    * @returns non zero on success
+    */
+    int  read_sector(char *data);
+    /** Write SECTOR_SIZE bytes to the sector address set by set_sector_address()
+    * @param data SECTOR_SIZE bytes
+    * @returns non zero on success
+    */
+    int  write_sector(const char *data);
     void display_image(int, int);
     void display_video(int, int);
     void display_frame(int, int, int);
@@ -309,11 +371,87 @@ public :
     int current_fx, current_fy;
     int current_wf, current_hf;
 
+// Transmit data
+    unsigned int bytes_sent;  // running count of bytes sent to the screen
+
+// Link health ******************************************************************************
+
+    /** Command statistics for one opcode */
+    struct command_stats {
+        uint16_t opcode;        // prefix << 8 | command, 0xFFD2 is LINE, 0x0006 is TEXTSTRING
+        uint32_t count;         // commands sent
+        uint32_t bytes;         // bytes sent, prefix and arguments included
+        uint32_t ack_min_us;    // time from the last byte sent to the answer
+        uint32_t ack_max_us;
+        uint64_t ack_total_us;
+        uint16_t naks;
+        uint16_t timeouts;
+    };
+
+    /** False once a command has timed out, commands are dropped until probe()
+    * gets an answer
+    */
+    bool online() {
+        return _online;
+    }
+
+    /** Try to get an answer from an offline screen, at the last baud rate and
+    * then at 9600 in case it has been power cycled.  The screen may have lost
+    * everything drawn and its baud rate, so redraw after this returns true.
+    * @returns true if the screen is online
+    *
+    * Example:
+    * @code
+    * if (!uLCD.online() && uLCD.probe()) {
+    *     uLCD.baudrate(3000000);
+    *     redraw_everything();
+    * }
+    * @endcode
+    */
+    bool probe();
+
+    /** Set how long to wait for an answer before marking the screen offline
+    * @param ms timeout in milliseconds, ACK_TIMEOUT_MS by default
+    */
+    void ack_timeout(int ms) {
+        _ack_timeout_ms = ms;
+    }
+
+    /** Number of opcodes with statistics, see stats() */
+    int stats_count() {
+        return _stats_used;
+    }
+
+    /** Statistics for one opcode
+    * @param index 0 to stats_count() - 1
+    */
+    const command_stats &stats(int index) {
+        return _stats[index];
+    }
+
+    /** Print a line per opcode: count, bytes, answer latency min/avg/max, NAKs and timeouts
+    * @param out where to print, e.g. the USB serial port
+    */
+    void print_stats(Stream &out);
+
+    /** Zero the command statistics */
+    void clear_stats();
+
 
 protected :
 
     Serial     _cmd;
     DigitalOut _rst;
+    int        _tx_chunk;  // bytes sent since the last chunk wait
+    int        _baud;      // what the screen and _cmd were last set to
+    bool       _online;
+    unsigned int _offline_count;
+    int        _ack_timeout_ms;
+    Timer      _ack_timer;
+    command_stats _stats[CMD_STATS];
+    int        _stats_used;
+    int        _cmd_slot;   // statistics of the command in progress
+    unsigned int _cmd_start; // bytes_sent when it started
     //used by printf
     virtual int _putc(int c) {
         putc(c);
@@ -323,7 +461,17 @@ protected :
         return -1;
     }
 
+    void putsBATCH   (const char *, int);
+    bool BLITstart   (int, int, int, int);
+    int  BLITend     (void);
     void freeBUFFER  (void);
+    bool beginCOMMAND(int);
+    int  waitACK     (void);
+    int  waitACK     (int);
+    int  waitANSWER  (int);
+    int  waitBYTE    (void);
+    int  waitBYTE    (int);
+    int  waitWORD    (void);
     void writeBYTE   (char);
     void writeBYTEfast   (char);
     int  writeCOMMAND(char *, int);
@@ -220,20 +220,34 @@ void uLCD_4DGL :: pixel(int x, int y, int color)     // draw a pixel
     writeCOMMAND(command, 7);
 }
 //****************************************************************************************************
-void uLCD_4DGL :: BLIT(int x, int y, int w, int h, int *colors)     // draw a block of pixels
+bool uLCD_4DGL :: BLITstart(int x, int y, int w, int h)     // command header for a block of pixels
 {
-    int red5, green6, blue5;
-    writeBYTEfast('\x00');
-    writeBYTEfast(BLITCOM);
-    writeBYTEfast((x >> 8) & 0xFF);
-    writeBYTEfast(x & 0xFF);
-    writeBYTEfast((y >> 8) & 0xFF);
-    writeBYTEfast(y & 0xFF);
-    writeBYTEfast((w >> 8) & 0xFF);
+    if (!beginCOMMAND(BLITCOM)) return false;
+    writeBYTE('\x00');
+    writeBYTE(BLITCOM);
+    writeBYTE((x >> 8) & 0xFF);
+    writeBYTE(x & 0xFF);
+    writeBYTE((y >> 8) & 0xFF);
+    writeBYTE(y & 0xFF);
+    writeBYTE((w >> 8) & 0xFF);
     writeBYTE(w & 0xFF);
     writeBYTE((h >> 8) & 0xFF);
     writeBYTE(h & 0xFF);
     wait_ms(1);
+    return true;
+}
+
+//****************************************************************************************************
+int uLCD_4DGL :: BLITend()     // wait for the answer to a block of pixels
+{
+    return waitACK();                                  // 1 ACK, -1 NAK, 0 no answer
+}
+
+//****************************************************************************************************
+void uLCD_4DGL :: BLIT(int x, int y, int w, int h, int *colors)     // draw a block of pixels
+{
+    int red5, green6, blue5;
+    if (!BLITstart(x, y, w, h)) return;
     for (int i=0; i<w*h; i++) {
         red5   = (colors[i] >> (16 + 3)) & 0x1F;              // get red on 5 bits
         green6 = (colors[i] >> (8 + 2))  & 0x3F;              // get green on 6 bits
@@ -241,24 +255,40 @@ void uLCD_4DGL :: BLIT(int x, int y, int w, int h, int *colors)     // draw a bl
         writeBYTEfast(((red5 << 3)   + (green6 >> 3)) & 0xFF);  // first part of 16 bits color
         writeBYTEfast(((green6 << 5) + (blue5 >> 0)) & 0xFF);  // second part of 16 bits color
     }
-    int resp=0;
-    while (!_cmd.readable()) wait_ms(TEMPO);              // wait for screen answer
-    if (_cmd.readable()) resp = _cmd.getc();           // read response if any
-    switch (resp) {
-        case ACK :                                     // if OK return   1
-            resp =  1;
-            break;
-        case NAK :                                     // if NOK return -1
-            resp = -1;
-            break;
-        default :
-            resp =  0;                                 // else return   0
-            break;
+    BLITend();
+}
+
+//****************************************************************************************************
+void uLCD_4DGL :: BLIT(int x, int y, int w, int h, const uint16_t *colors)     // draw a block of RGB565 pixels
+{
+    if (!BLITstart(x, y, w, h)) return;
+    for (int i=0; i<w*h; i++) {
+        writeBYTEfast((colors[i] >> 8) & 0xFF);               // already in screen format
+        writeBYTEfast(colors[i] & 0xFF);
     }
-#if DEBUGMODE
-    pc.printf("   Answer received : %d\n",resp);
-#endif
+    BLITend();
+}
 
+//****************************************************************************************************
+void uLCD_4DGL :: BLIT_RLE(int x, int y, int w, int h, const uint16_t *runs)     // draw a block of run length encoded RGB565 pixels
+{
+    // runs are (count, color) pairs covering exactly w*h pixels
+    int pixels = w*h;
+    if (!BLITstart(x, y, w, h)) return;
+    while (pixels > 0) {
+        int count = runs[0];
+        char hi = (runs[1] >> 8) & 0xFF;
+        char lo = runs[1] & 0xFF;
+        if (count > pixels) count = pixels;                   // never send more than the screen expects
+        if (count == 0) break;                                // corrupt data, screen will time out the command
+        pixels -= count;
+        while (count--) {
+            writeBYTEfast(hi);
+            writeBYTEfast(lo);
+        }
+        runs += 2;
+    }
+    BLITend();
 }
 //******************************************************************************************************
 int uLCD_4DGL :: read_pixel(int x, int y)   // read screen info and populate data
@@ -277,16 +307,16 @@ int uLCD_4DGL :: read_pixel(int x, int y)   // read screen info and populate dat
     int i, temp = 0, color = 0, resp = 0;
     char response[3] = "";
 
-    freeBUFFER();
+    if (!beginCOMMAND(0xFF00 | (READPIXEL & 0xFF))) return 0;
 
     for (i = 0; i < 6; i++) {                   // send all chars to serial port
         writeBYTE(command[i]);
     }
 
-    while (!_cmd.readable()) wait_ms(TEMPO);    // wait a bit for screen answer
-
-    while ( resp < ARRAY_SIZE(response)) {   //read ack and 16-bit color response
-        temp = _cmd.getc();
+    if (waitACK() == 0) return 0;               // no answer, offline
+    response[resp++] = ACK;
+    while ( resp < ARRAY_SIZE(response)) {   //then the 16-bit color response
+        if ((temp = waitBYTE()) < 0) return 0;
         response[resp++] = (char)temp;
     }
 
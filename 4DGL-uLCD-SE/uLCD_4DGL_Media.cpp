@@ -29,13 +29,9 @@ int uLCD_4DGL :: media_init()
     int resp = 0;
     char command[1] = "";
     command[0] = MINIT;
-    writeCOMMAND(command, 1);
-    while (!_cmd.readable()) wait_ms(TEMPO);              // wait for screen answer
-    if (_cmd.readable()) {
-        resp = _cmd.getc();           // read response
-        resp = resp << 8 + _cmd.getc();
-    }
-    return resp;
+    if (writeCOMMAND(command, 1) == 0) return 0;   // reads the ACK
+    resp = waitWORD();                // read response word
+    return (resp < 0) ? 0 : resp;     // timed out
 }
 
 //******************************************************************************************************
@@ -73,12 +69,9 @@ char uLCD_4DGL :: read_byte()
     char resp = 0;
     char command[1] = "";
     command[0] = READBYTE;
-    writeCOMMAND(command, 1);
-    while (!_cmd.readable()) wait_ms(TEMPO);              // wait for screen answer
-    if (_cmd.readable()) {
-        resp = _cmd.getc();           // read response
-        resp = _cmd.getc();
-    }
+    if (writeCOMMAND(command, 1) == 0) return 0;   // reads the ACK
+    int word = waitWORD();            // high byte is 0
+    if (word >= 0) resp = word & 0xFF;
     return resp;
 }
 
@@ -88,13 +81,9 @@ int  uLCD_4DGL :: read_word()
     int resp=0;
     char command[1] = "";
     command[0] = READWORD;
-    writeCOMMAND(command, 1);
-    while (!_cmd.readable()) wait_ms(TEMPO);              // wait for screen answer
-    if (_cmd.readable()) {
-        resp = _cmd.getc();           // read response
-        resp = resp << 8 + _cmd.getc();
-    }
-    return resp;
+    if (writeCOMMAND(command, 1) == 0) return 0;   // reads the ACK
+    resp = waitWORD();                // read response word
+    return (resp < 0) ? 0 : resp;     // timed out
 }
 
 //******************************************************************************************************
@@ -129,6 +118,38 @@ void uLCD_4DGL :: flush_media()
     writeCOMMAND(command, 1);
 }
 
+//******************************************************************************************************
+int uLCD_4DGL :: read_sector(char *data)
+{
+    int i, c, resp = 0;
+    if (!beginCOMMAND(READSECTOR)) return 0;
+    writeBYTE('\x00');
+    writeBYTE(READSECTOR);
+    if (waitACK() != 1) return 0;
+    resp = waitWORD();                // status word, then the sector
+    if (resp < 0) return 0;
+    if (resp) {
+        for (i = 0; i < SECTOR_SIZE; i++) {
+            if ((c = waitBYTE()) < 0) return 0;
+            data[i] = c;
+        }
+    }
+    return resp;
+}
+
+//******************************************************************************************************
+int uLCD_4DGL :: write_sector(const char *data)
+{
+    int i, resp = 0;
+    if (!beginCOMMAND(WRITESECTOR)) return 0;
+    writeBYTE('\x00');
+    writeBYTE(WRITESECTOR);
+    for (i = 0; i < SECTOR_SIZE; i++) writeBYTE(data[i]);  // paced by chunk
+    if (waitACK() != 1) return 0;
+    resp = waitWORD();                // status word
+    return (resp < 0) ? 0 : resp;
+}
+
 //******************************************************************************************************
 void uLCD_4DGL :: display_image(int x, int y)
 {
@@ -233,7 +233,9 @@ void uLCD_4DGL :: text_string(char *s, char col, char row, char font, int color)
     command[0] = TEXTSTRING;
     for (i=0; i<size; i++) command[1+i] = s[i];
     command[1+size] = 0;
-    writeCOMMANDnull(command, 2 + size);
+    if (writeCOMMANDnull(command, 2 + size) == 1) {
+        waitWORD();                 // string length, don't leave it for the next command
+    }
 }
 
 
@@ -326,18 +328,76 @@ void uLCD_4DGL :: putc(char c)      // place char at current cursor position
 
 
 //****************************************************************************************************
-void uLCD_4DGL :: puts(char *s)     // place string at current cursor position
+void uLCD_4DGL :: puts(const char *s)     // place string at current cursor position
+{
+    putsBATCH(s, strlen(s));
+}
+
+//****************************************************************************************************
+int uLCD_4DGL :: printf(const char *format, ...)     // formatted string at current cursor position
 {
+    char buffer[PRINTF_BUFFER];
+    va_list args;
 
-    text_string(s, current_col, current_row, current_font, current_color);
+    va_start(args, format);
+    int size = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
 
-    current_col += strlen(s);
+    if (size < 0) return size;
+    if (size >= (int)sizeof(buffer)) size = sizeof(buffer) - 1;  // truncated
+    putsBATCH(buffer, size);
+    return size;
+}
 
-    if (current_col >= max_col) {
-        current_row += current_col / max_col;
-        current_col %= max_col;
-    }
-    if (current_row >= max_row) {
-        current_row %= max_row;
+//****************************************************************************************************
+void uLCD_4DGL :: putsBATCH(const char *s, int size)     // runs of printable chars as one string command each
+//cursor bookkeeping matches calling putc for each char
+{
+    char command[PRINTF_BUFFER + 2];
+    int i = 0;
+
+    while (i < size) {
+        if (s[i] < 0x20) {
+            putc(s[i++]);  // control chars move the cursor
+            continue;
+        }
+        // printable run, broken at the end of the line so wrapping matches putc
+        int run = 0;
+        int room = max_col - current_col;
+        if (room > PRINTF_BUFFER) room = PRINTF_BUFFER;
+        while ((i + run < size) && (run < room) && (s[i + run] >= 0x20)) {
+            command[1 + run] = s[i + run];
+            run++;
+        }
+        if (run == 0) {
+            putc(s[i++]);  // cursor is off the end of the line, let putc sort it out
+            continue;
+        }
+        command[0] = TEXTSTRING;
+        command[1 + run] = 0;
+        if (writeCOMMANDnull(command, 2 + run) == 1) {
+            waitWORD();             // string length, don't leave it for the next command
+        }
+        i += run;
+        current_col += run;
+        if (current_col >= max_col) {
+            current_col = 0;
+            current_row++;
+            command[0] = MOVECURSOR; //move cursor to next line
+            command[1] = 0;
+            command[2] = current_row;
+            command[3] = 0;
+            command[4] = current_col;
+            writeCOMMAND(command, 5);
+        }
+        if (current_row >= max_row) {
+            current_row = 0;
+            command[0] = MOVECURSOR; //move cursor back to start
+            command[1] = 0;
+            command[2] = current_row;
+            command[3] = 0;
+            command[4] = current_col;
+            writeCOMMAND(command, 5);
+        }
     }
 }
@@ -26,7 +26,7 @@
 
 
 //******************************************************************************************************
-uLCD_4DGL :: uLCD_4DGL(PinName tx, PinName rx, PinName rst) : _cmd(tx, rx),
+uLCD_4DGL :: uLCD_4DGL(PinName tx, PinName rx, PinName rst, bool init) : _cmd(tx, rx),
     _rst(rst)
 #if DEBUGMODE
     ,pc(USBTX, USBRX)
@@ -34,6 +34,16 @@ uLCD_4DGL :: uLCD_4DGL(PinName tx, PinName rx, PinName rst) : _cmd(tx, rx),
 {
     // Constructor
     _cmd.baud(9600);
+    _baud      = 9600;
+    bytes_sent = 0;
+    _tx_chunk  = 0;
+    _online    = true;
+    _offline_count  = 0;
+    _ack_timeout_ms = ACK_TIMEOUT_MS;
+    _cmd_slot  = 0;
+    _cmd_start = 0;
+    clear_stats();
+    _ack_timer.start();
 #if DEBUGMODE
     pc.baud(115200);
 
@@ -44,14 +54,25 @@ uLCD_4DGL :: uLCD_4DGL(PinName tx, PinName rx, PinName rst) : _cmd(tx, rx),
 #endif
 
     _rst = 1;    // put RESET pin to high to start TFT screen
-    reset();
-    cls();       // clear screen
     current_col         = 0;            // initial cursor col
     current_row         = 0;            // initial cursor row
     current_color       = WHITE;        // initial text color
     current_orientation = IS_PORTRAIT;  // initial screen orientation
     current_hf = 1;
     current_wf = 1;
+    current_font = FONT_7X8;
+    if (init) this->init();
+}
+
+void uLCD_4DGL :: init()   // bring the screen up, blocks for the 3s reset
+{
+    _cmd.baud(9600);                    // screen comes out of reset at 9600
+    _baud = 9600;
+    reset();
+    _online = true;                     // cls() finds out if it isn't
+    cls();       // clear screen
+    current_col = 0;
+    current_row = 0;
     set_font(FONT_7X8);                 // initial font
 //   text_mode(OPAQUE);                  // initial texr mode
 }
@@ -61,7 +82,13 @@ void uLCD_4DGL :: writeBYTE(char c)   // send a BYTE command to screen
 {
 
     _cmd.putc(c);
-    wait_us(500);  //mbed is too fast for LCD at high baud rates in some long commands
+    bytes_sent++;
+    if (++_tx_chunk >= TX_CHUNK) {
+        //mbed is too fast for LCD at high baud rates in some long commands
+        //let the screen drain its buffer once per chunk, not once per byte
+        wait_us(TX_CHUNK_WAIT_US);
+        _tx_chunk = 0;
+    }
 
 #if DEBUGMODE
     pc.printf("   Char sent : 0x%02X\n",c);
@@ -74,6 +101,7 @@ void uLCD_4DGL :: writeBYTEfast(char c)   // send a BYTE command to screen
 {
 
     _cmd.putc(c);
+    bytes_sent++;
     //wait_ms(0.0);  //mbed is too fast for LCD at high baud rates - but not in short commands
 
 #if DEBUGMODE
@@ -86,32 +114,47 @@ void uLCD_4DGL :: freeBUFFER(void)         // Clear serial buffer before writing
 {
 
     while (_cmd.readable()) _cmd.getc();  // clear buffer garbage
+    _tx_chunk = 0;                        // new command, screen buffer is empty
 }
 
 //******************************************************************************************************
-int uLCD_4DGL :: writeCOMMAND(char *command, int number)   // send several BYTES making a command and return an answer
+bool uLCD_4DGL :: beginCOMMAND(int opcode)   // start a command, false while the screen is offline
 {
-
-#if DEBUGMODE
-    pc.printf("\n");
-    pc.printf("New COMMAND : 0x%02X\n", command[0]);
-#endif
-    int i, resp = 0;
+    if (!_online) return false;
     freeBUFFER();
-    writeBYTE(0xFF);
-    for (i = 0; i < number; i++) {
-        if (i<16)
-            writeBYTEfast(command[i]); // send command to serial port
-        else
-            writeBYTE(command[i]); // send command to serial port but slower
+
+    // find the opcode's statistics, the last slot collects the overflow
+    _cmd_slot = CMD_STATS - 1;
+    for (int i = 0; i < _stats_used; i++) {
+        if (_stats[i].opcode == opcode) {
+            _cmd_slot = i;
+            break;
+        }
+    }
+    if ((_cmd_slot == CMD_STATS - 1) && (_stats_used < CMD_STATS - 1)) {
+        _cmd_slot = _stats_used++;
+        _stats[_cmd_slot].opcode = opcode;
     }
-    while (!_cmd.readable()) wait_ms(TEMPO);              // wait for screen answer
-    if (_cmd.readable()) resp = _cmd.getc();           // read response if any
+    _stats[_cmd_slot].count++;
+    _cmd_start = bytes_sent;
+    return true;
+}
+
+//******************************************************************************************************
+int uLCD_4DGL :: waitACK(void)   // wait for the answer to the command in progress
+{
+    return waitACK(_ack_timeout_ms);
+}
+
+int uLCD_4DGL :: waitACK(int timeout_ms)
+{
+    int resp = waitANSWER(timeout_ms);
     switch (resp) {
         case ACK :                                     // if OK return   1
             resp =  1;
             break;
         case NAK :                                     // if NOK return -1
+            _stats[_cmd_slot].naks++;
             resp = -1;
             break;
         default :
@@ -121,10 +164,73 @@ int uLCD_4DGL :: writeCOMMAND(char *command, int number)   // send several BYTES
 #if DEBUGMODE
     pc.printf("   Answer received : %d\n",resp);
 #endif
+    return resp;
+}
 
+//******************************************************************************************************
+int uLCD_4DGL :: waitANSWER(int timeout_ms)   // first byte of the answer, -1 on timeout
+{
+    command_stats &stat = _stats[_cmd_slot];
+    uint32_t start = _ack_timer.read_us();
+    stat.bytes += bytes_sent - _cmd_start;
+
+    int resp = waitBYTE(timeout_ms);
+    if (resp < 0) return -1;                           // timed out, now offline
+    uint32_t latency = (uint32_t)_ack_timer.read_us() - start;
+    if (latency < stat.ack_min_us) stat.ack_min_us = latency;
+    if (latency > stat.ack_max_us) stat.ack_max_us = latency;
+    stat.ack_total_us += latency;
     return resp;
 }
 
+//******************************************************************************************************
+int uLCD_4DGL :: waitBYTE(void)   // next byte of the answer, -1 on timeout
+{
+    return waitBYTE(_ack_timeout_ms);
+}
+
+int uLCD_4DGL :: waitBYTE(int timeout_ms)
+{
+    uint32_t start = _ack_timer.read_us();
+    while (!_cmd.readable()) {
+        if ((uint32_t)_ack_timer.read_us() - start >= (uint32_t)timeout_ms * 1000) {
+            // unplugged, wedged or at another baud rate, stop talking to it
+            _stats[_cmd_slot].timeouts++;
+            if (_online) _offline_count++;
+            _online = false;
+            return -1;
+        }
+        wait_ms(TEMPO);
+    }
+    return _cmd.getc();
+}
+
+int uLCD_4DGL :: waitWORD(void)   // next big endian word of the answer, -1 on timeout
+{
+    int hi = waitBYTE();
+    if (hi < 0) return -1;
+    int lo = waitBYTE();
+    if (lo < 0) return -1;
+    return (hi << 8) | lo;
+}
+
+//******************************************************************************************************
+int uLCD_4DGL :: writeCOMMAND(char *command, int number)   // send several BYTES making a command and return an answer
+{
+
+#if DEBUGMODE
+    pc.printf("\n");
+    pc.printf("New COMMAND : 0x%02X\n", command[0]);
+#endif
+    int i;
+    if (!beginCOMMAND(0xFF00 | (command[0] & 0xFF))) return 0;
+    writeBYTE(0xFF);
+    for (i = 0; i < number; i++) {
+        writeBYTE(command[i]); // send command to serial port, paced by chunk
+    }
+    return waitACK();                                  // 1 ACK, -1 NAK, 0 no answer
+}
+
 //**************************************************************************
 void uLCD_4DGL :: reset()    // Reset Screen
 {
@@ -144,33 +250,13 @@ int uLCD_4DGL :: writeCOMMANDnull(char *command, int number)   // send several B
     pc.printf("\n");
     pc.printf("New COMMAND : 0x%02X\n", command[0]);
 #endif
-    int i, resp = 0;
-    freeBUFFER();
+    int i;
+    if (!beginCOMMAND(command[0] & 0xFF)) return 0;
     writeBYTE(0x00); //command has a null prefix byte
     for (i = 0; i < number; i++) {
-        if (i<16) //don't overflow LCD UART buffer
-            writeBYTEfast(command[i]); // send command to serial port
-        else
-            writeBYTE(command[i]); // send command to serial port with delay
-    }
-    while (!_cmd.readable()) wait_ms(TEMPO);              // wait for screen answer
-    if (_cmd.readable()) resp = _cmd.getc();           // read response if any
-    switch (resp) {
-        case ACK :                                     // if OK return   1
-            resp =  1;
-            break;
-        case NAK :                                     // if NOK return -1
-            resp = -1;
-            break;
-        default :
-            resp =  0;                                 // else return   0
-            break;
+        writeBYTE(command[i]); // send command to serial port, paced by chunk so we don't overflow LCD UART buffer
     }
-#if DEBUGMODE
-    pc.printf("   Answer received : %d\n",resp);
-#endif
-
-    return resp;
+    return waitACK();                                  // 1 ACK, -1 NAK, 0 no answer
 }
 
 //**************************************************************************
@@ -201,6 +287,7 @@ int uLCD_4DGL :: version()    // get API version
 void uLCD_4DGL :: baudrate(int speed)    // set screen baud rate
 {
     char command[3]= "";
+    if (!beginCOMMAND(BAUDRATE)) return;
     writeBYTE(0x00);
     command[0] = BAUDRATE;
     command[1] = 0;
@@ -287,9 +374,8 @@ void uLCD_4DGL :: baudrate(int speed)    // set screen baud rate
             break;
     }
 
-    int i, resp = 0;
+    int i;
 
-    freeBUFFER();
     command[1] = char(newbaud >>8);
     command[2] = char(newbaud % 256);
     wait_ms(1);
@@ -297,23 +383,8 @@ void uLCD_4DGL :: baudrate(int speed)    // set screen baud rate
     for (i = 0; i<10; i++) wait_ms(1); 
     //dont change baud until all characters get sent out
     _cmd.baud(speed);                                  // set mbed to same speed
-    i=0;
-    while ((!_cmd.readable()) && (i<25000)) {
-        wait_ms(TEMPO);           // wait for screen answer - comes 100ms after change
-        i++; //timeout if ack character missed by baud change
-    }
-    if (_cmd.readable()) resp = _cmd.getc();           // read response if any
-    switch (resp) {
-        case ACK :                                     // if OK return   1
-            resp =  1;
-            break;
-        case NAK :                                     // if NOK return -1
-            resp = -1;
-            break;
-        default :
-            resp =  0;                                 // else return   0
-            break;
-    }
+    _baud = speed;
+    waitACK(_ack_timeout_ms + 100);                    // screen answers 100ms after the change
 }
 
 //******************************************************************************************************
@@ -323,11 +394,12 @@ int uLCD_4DGL :: readVERSION(char *command, int number)   // read screen info an
     int i, temp = 0, resp = 0;
     char response[5] = "";
 
-    freeBUFFER();
+    if (!beginCOMMAND(((command[0] & 0xFF) << 8) | (command[1] & 0xFF))) return 0;
 
     for (i = 0; i < number; i++) writeBYTE(command[i]);    // send all chars to serial port
 
-    while (!_cmd.readable()) wait_ms(TEMPO);               // wait for screen answer
+    if ((temp = waitANSWER(_ack_timeout_ms)) < 0) return 0; // nothing came back, offline
+    response[resp++] = (char)temp;
 
     while (_cmd.readable() && resp < ARRAY_SIZE(response)) {
         temp = _cmd.getc();
@@ -441,11 +513,12 @@ int uLCD_4DGL :: getSTATUS(char *command, int number)   // read screen info and
     int i, temp = 0, resp = 0;
     char response[5] = "";
 
-    freeBUFFER();
+    if (!beginCOMMAND(((command[0] & 0xFF) << 8) | (command[1] & 0xFF))) return -1;
 
     for (i = 0; i < number; i++) writeBYTE(command[i]);    // send all chars to serial port
 
-    while (!_cmd.readable()) wait_ms(TEMPO);    // wait for screen answer
+    if ((temp = waitANSWER(_ack_timeout_ms)) < 0) return -1; // nothing came back, offline
+    response[resp++] = (char)temp;
 
     while (_cmd.readable() && resp < ARRAY_SIZE(response)) {
         temp = _cmd.getc();
@@ -467,3 +540,60 @@ int uLCD_4DGL :: getSTATUS(char *command, int number)   // read screen info and
     return resp;
 }
 
+//******************************************************************************************************
+bool uLCD_4DGL :: probe()   // look for an offline screen
+{
+    if (_online) return true;
+
+    // the cursor move changes nothing on the screen, try the rate it was left at
+    _online = true;
+    locate(current_col, current_row);
+    if (_online || (_baud == 9600)) return _online;
+
+    // then the rate it comes out of a power cycle at
+    _cmd.baud(9600);
+    _online = true;
+    locate(current_col, current_row);
+    if (_online) {
+        _baud = 9600;
+    } else {
+        _cmd.baud(_baud);
+    }
+    return _online;
+}
+
+//******************************************************************************************************
+void uLCD_4DGL :: clear_stats()
+{
+    for (int i = 0; i < CMD_STATS; i++) {
+        _stats[i].opcode       = 0;
+        _stats[i].count        = 0;
+        _stats[i].bytes        = 0;
+        _stats[i].ack_min_us   = 0xFFFFFFFF;
+        _stats[i].ack_max_us   = 0;
+        _stats[i].ack_total_us = 0;
+        _stats[i].naks         = 0;
+        _stats[i].timeouts     = 0;
+    }
+    _stats[CMD_STATS - 1].opcode = 0xFFFF;   // everything that didn't get a slot
+    _stats_used = 0;
+}
+
+//******************************************************************************************************
+void uLCD_4DGL :: print_stats(Stream &out)
+{
+    out.printf("uLCD %s, %d baud, %u bytes, offline %u times, timeout %d ms\n",
+               _online ? "online" : "OFFLINE", _baud, bytes_sent, _offline_count, _ack_timeout_ms);
+    out.printf("opcode  count     bytes  ack min/avg/max us  nak  t/o\n");
+    for (int i = 0; i < CMD_STATS; i++) {
+        const command_stats &stat = _stats[i];
+        if ((i >= _stats_used) && (i != CMD_STATS - 1)) continue;
+        if (stat.count == 0) continue;
+        uint32_t answered = stat.count - stat.timeouts;
+        out.printf(" %04X %7lu %9lu %6lu/%6lu/%6lu %4u %4u\n", stat.opcode,
+                   (unsigned long)stat.count, (unsigned long)stat.bytes,
+                   answered ? (unsigned long)stat.ack_min_us : 0UL,
+                   answered ? (unsigned long)(stat.ack_total_us / answered) : 0UL,
+                   (unsigned long)stat.ack_max_us, stat.naks, stat.timeouts);
+    }
+}
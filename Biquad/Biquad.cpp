@@ -0,0 +1,69 @@
+/* Mbed fixed point biquad filter
+
+Copyright 2020 Jonathan L. Martin <jon.martini@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so, 
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+
+*/
+
+#include "Biquad.h"
+
+Biquad::Biquad(const int32_t *coefficients, int stages, int post_shift) {
+    _coefficients = coefficients;
+    _stages       = (stages < 0) ? 0 : (stages > kMaxStages) ? kMaxStages : stages;
+    _post_shift   = post_shift;
+#if BIQUAD_CMSIS_DSP
+    arm_biquad_cascade_df1_init_q31(&_instance, (uint8_t)_stages, (q31_t *)_coefficients, _state, (int8_t)_post_shift);
+#endif
+    reset(0);
+}
+
+int32_t Biquad::filter(int32_t x) {
+#if BIQUAD_CMSIS_DSP
+    arm_biquad_cascade_df1_q31(&_instance, &x, &_output, 1);
+#else
+    const int      shift = 31 - _post_shift;
+    const int32_t *c     = _coefficients;
+    int32_t       *s     = _state;
+    for (int i = 0; i < _stages; i++) {
+        int64_t acc = (int64_t)c[0] * x;
+        acc += (int64_t)c[1] * s[0];
+        acc += (int64_t)c[2] * s[1];
+        acc += (int64_t)c[3] * s[2];
+        acc += (int64_t)c[4] * s[3];
+        const int32_t y = (int32_t)(acc >> shift);
+        s[1] = s[0];
+        s[0] = x;
+        s[3] = s[2];
+        s[2] = y;
+        x = y;
+        c += 5;
+        s += 4;
+    }
+    _output = x;
+#endif
+    return _output;
+}
+
+void Biquad::reset(int32_t value) {
+    for (int i = 0; i < 4 * kMaxStages; i++) {
+        _state[i] = value;
+    }
+    _output = value;
+}
@@ -0,0 +1,120 @@
+/* Mbed fixed point biquad filter
+
+Copyright 2020 Jonathan L. Martin <jon.martini@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so, 
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+
+A cascade of second order sections in direct form I on Q31 samples, the same
+arithmetic as CMSIS-DSP's arm_biquad_cascade_df1_q31: 32 x 32 bit products
+summed in 64 bits, shifted back down once per stage, no floating point.
+Coefficients are b0, b1, b2, a1, a2 per stage with a1 and a2 negated, all
+scaled down by 2^post_shift so they fit in Q31.  tools/biquad_design.py
+designs them and checks the response bit for bit on the host, and with
+--firmware builds this file for the host and checks it too.
+
+arm_math.h is in the mbed tree but the CMSIS-DSP library itself isn't linked
+in this export, so the loop is here.  Build with BIQUAD_CMSIS_DSP=1 and the
+mbed-dsp library to hand each sample to arm_biquad_cascade_df1_q31 instead;
+coefficients and state are laid out for it, the output is the same.
+
+*/
+
+#ifndef MBED_BIQUAD_H
+#define MBED_BIQUAD_H
+
+#include "mbed.h"
+
+#ifndef BIQUAD_CMSIS_DSP
+#define BIQUAD_CMSIS_DSP 0
+#endif
+
+#if BIQUAD_CMSIS_DSP
+#include "arm_math.h"
+#endif
+
+/** Fixed point biquad cascade, one sample at a time
+ *
+ * Example:
+ * @code
+ * // 4 pole low pass on a thermistor, sampled at the rate it was designed for
+ * #include "mbed.h"
+ * #include "Biquad.h"
+ * #include "thermistor_filter.h"
+ * 
+ * AnalogIn sensor(p20);
+ * Biquad lowpass(kThermistorFilter, kThermistorFilterStages, kThermistorFilterPostShift);
+ * 
+ * int main() {
+ *     lowpass.reset((int32_t)sensor.read_u16() << kFilterInputShift);
+ *     while(1) {
+ *         int32_t y = lowpass.filter((int32_t)sensor.read_u16() << kFilterInputShift);
+ *         uint16_t filtered = y >> kFilterInputShift;
+ *         wait(1.0 / kFilterRate_Hz);
+ *     }
+ * }
+ * @endcode
+ */
+class Biquad {
+public:
+
+    enum { kMaxStages = 4 };
+
+    /** Create a filter, starting at rest at 0
+     *
+     * @param coefficients - b0, b1, b2, a1, a2 per stage in Q31, CMSIS DF1 layout.  Not copied, must stay valid.
+     * @param stages - Number of second order stages, up to kMaxStages
+     * @param post_shift - Coefficients were scaled down by 2^post_shift
+     */
+    Biquad(const int32_t *coefficients, int stages, int post_shift);
+
+    /** Filter one sample
+     *
+     * Leave headroom in the input, a step overshoots and CMSIS wraps
+     * rather than saturates.
+     *
+     * @param x - Input sample, Q31
+     * @returns The filtered sample, Q31
+     */
+    int32_t filter(int32_t x);
+
+    /** Settle the filter at a value, as if it had been the input forever
+     *
+     * Assumes each stage has unity gain at DC, as a low pass does.
+     *
+     * @param value - Q31 value to start from
+     */
+    void reset(int32_t value);
+
+    /** Get the last filtered sample */
+    int32_t output(void) const {
+        return _output;
+    }
+
+protected:
+    const int32_t *_coefficients;
+    int            _stages;
+    int            _post_shift;
+    int32_t        _state[4 * kMaxStages];  // x[n-1], x[n-2], y[n-1], y[n-2] per stage
+    int32_t        _output;
+#if BIQUAD_CMSIS_DSP
+    arm_biquad_casd_df1_inst_q31 _instance;
+#endif
+};
+
+#endif
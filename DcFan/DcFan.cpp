@@ -23,12 +23,22 @@ SOFTWARE.
 This library allows setting a minimum threshold for fans to turn on,
 but otherwise uses PWM like any other motor.
 
+Optionally a stopped fan can be kick started at full speed so it can then
+hold a speed below the threshold it needs to start spinning.
+
+With tach inputs the fan can be run closed loop.  All fans share one PWM line
+so they are regulated on their average RPM; a single stalled or clogged fan is
+reported through stalled() rather than chased with more PWM.
+
 */
 
 #include "DcFan.h"
 
 #include "mbed.h"
 
+// A fan driven this long past its kick without a revolution is stalled
+const float kStallTime_s = 2.0;
+
 DcFan::DcFan(PinName pwm, float min_active_pwm):
     _pwm(pwm) {
 
@@ -42,6 +52,38 @@ DcFan::DcFan(PinName pwm, float min_active_pwm):
     {
         _min_active_pwm = 0.0;
     }
+    _min_running_pwm = _min_active_pwm;
+    _kick_time_s     = 0.0;
+    _kicking         = false;
+    _set_speed       = 0.0;
+    _drive           = 0.0;
+    _num_tachs       = 0;
+    _stalled         = false;
+    _max_rpm         = 0.0;
+    _gain            = 0.0;
+    _trim            = 0.0;
+    _running_timer.start();
+}
+
+void DcFan::kick_start(float kick_time_s, float min_running_pwm)
+{
+    if (kick_time_s > 0.0)
+    {
+        _kick_time_s = kick_time_s;
+    } else
+    {
+        _kick_time_s = 0.0;
+    }
+    // Can't hold a fan below zero, and no point in a floor above the start threshold
+    if (min_running_pwm < 0.0)
+    {
+        min_running_pwm = 0.0;
+    }
+    if ((_kick_time_s == 0.0) || (min_running_pwm > _min_active_pwm))
+    {
+        min_running_pwm = _min_active_pwm;
+    }
+    _min_running_pwm = min_running_pwm;
 }
 
 void DcFan::speed(float speed) {
@@ -51,9 +93,155 @@ void DcFan::speed(float speed) {
         speed = 1.0;
         // TODO warning?
     }
-    if (speed < _min_active_pwm)
+    if (speed < _min_running_pwm)
     {
         speed = 0.0;
     }
-    _pwm = speed;
+
+    const bool stopped = (_set_speed == 0.0);
+    _set_speed = speed;
+
+    if (stopped && (speed == 0.0))
+    {
+        ; // already off
+    } else if (speed == 0.0)
+    {
+        _kick_timeout.detach();
+        _kicking = false;
+        _drive   = 0.0;
+        _pwm     = 0.0;
+        _stalled = false;
+    } else
+    {
+        if (stopped)
+        {
+            _running_timer.reset();
+        }
+        drive(speed + _trim, stopped);
+    }
+}
+
+void DcFan::drive(float pwm, bool starting)
+{
+    // Stay within what a spinning fan can hold
+    if (pwm > 1.0)
+    {
+        pwm = 1.0;
+    }
+    if (pwm < _min_running_pwm)
+    {
+        pwm = _min_running_pwm;
+    }
+    const float last_pwm = _drive;
+    _drive = pwm;
+
+    if (_kicking)
+    {
+        ; // end_kick() picks up the new _drive
+    } else if (starting && (pwm < _min_active_pwm))
+    {
+        // Too slow to start on its own, give it a shove
+        _kicking = true;
+        _pwm = 1.0;
+        _kick_timeout.attach(callback(this, &DcFan::end_kick), _kick_time_s);
+    } else if (pwm != last_pwm)
+    {
+        _pwm = pwm;
+    }
+}
+
+float DcFan::current_speed(void) {
+    return _set_speed;
+}
+
+void DcFan::end_kick(void) {
+    _kicking = false;
+    _pwm = _drive;
+}
+
+bool DcFan::add_tach(PinName tach_pin, int pulses_per_rev)
+{
+    if (_num_tachs >= kMaxTachs)
+    {
+        return false;
+    }
+    _tachs[_num_tachs++] = new FanTach(tach_pin, pulses_per_rev);
+    return true;
+}
+
+void DcFan::closed_loop(float max_rpm, float gain)
+{
+    _max_rpm = (max_rpm > 0.0) ? max_rpm : 0.0;
+    _gain    = (gain    > 0.0) ? gain    : 0.0;
+    _trim    = 0.0;
+}
+
+float DcFan::rpm(int fan)
+{
+    if ((fan < 0) || (fan >= _num_tachs))
+    {
+        return 0.0;
+    }
+    return _tachs[fan]->rpm(kStallTime_s);
+}
+
+float DcFan::rpm(void)
+{
+    float total_rpm = 0.0;
+    int   turning   = 0;
+    for (int i = 0; i < _num_tachs; i++)
+    {
+        const float this_rpm = rpm(i);
+        if (this_rpm > 0.0)
+        {
+            total_rpm += this_rpm;
+            turning++;
+        }
+    }
+    return (turning > 0) ? total_rpm / float(turning) : 0.0;
+}
+
+bool DcFan::stalled(void)
+{
+    return _stalled;
+}
+
+void DcFan::update(float period_s)
+{
+    if ((_set_speed == 0.0) || _kicking)
+    {
+        _stalled = false;
+        return;
+    }
+
+    // Give the fans time to spin up before judging them
+    if (_running_timer.read() > _kick_time_s + kStallTime_s)
+    {
+        bool any_stalled = false;
+        for (int i = 0; i < _num_tachs; i++)
+        {
+            if (rpm(i) == 0.0)
+            {
+                any_stalled = true;
+            }
+        }
+        _stalled = any_stalled;
+    }
+
+    // No point winding up the trim chasing a fan that isn't turning
+    if ((_max_rpm > 0.0) && (_num_tachs > 0) && !_stalled)
+    {
+        // Integrate the rpm error into a pwm trim on top of the feed forward
+        const float error = (_set_speed * _max_rpm - rpm()) / _max_rpm;
+        _trim += _gain * error * period_s;
+        if (_trim > 1.0)
+        {
+            _trim = 1.0;
+        }
+        if (_trim < -1.0)
+        {
+            _trim = -1.0;
+        }
+        drive(_set_speed + _trim, false);
+    }
 }
@@ -27,8 +27,12 @@ Allows setting a minimum threshold
 #define MBED_DC_FAN_H
 
 #include "mbed.h"
+#include "FanTach.h"
 
-/** Interface to control a 2 pin DC fan.  Set speed with PWM. No rpm readings
+/** Interface to control a DC fan.  Set speed with PWM.
+ *
+ * Optionally add tach inputs for each fan sharing the PWM line to read RPMs,
+ * detect stalled fans, and hold a target RPM instead of a fixed PWM.
  *
  * Drive a fan using a PwmOut
  * Example:
@@ -52,6 +56,25 @@ Allows setting a minimum threshold
  *     }
  * }
  * @endcode
+ *
+ * Closed loop:
+ * @code
+ * DcFan myFans(p26, 0.5);
+ * 
+ * int main() {
+ *     myFans.add_tach(p25, 2);         // tach pin, pulses per revolution
+ *     myFans.closed_loop(1800.0, 0.5); // speed 1.0 = 1800 rpm
+ *     myFans.speed(0.5);               // hold 900 rpm
+ *     while(1) {
+ *         myFans.update(1.0);
+ *         if (myFans.stalled())
+ *         {
+ *             printf("Fan stalled!\n");
+ *         }
+ *         wait(1.0);
+ *     }
+ * }
+ * @endcode
  */
 class DcFan {
 public:
@@ -71,9 +94,77 @@ public:
     /** Get the set speed of the motor, does *not* read RPMs from fan */
     float current_speed(void);
 
+    /** Maximum number of tach inputs, one per fan sharing the pwm line */
+    enum { kMaxTachs = 3 };
+
+    /** Add a tach input for one of the fans driven by this pwm line
+     *
+     * @param tach_pin An InterruptIn pin connected to the fan tach line
+     * @param pulses_per_rev Tach pulses per revolution, usually 2
+     * @returns false if kMaxTachs are already attached
+     */
+    bool add_tach(PinName tach_pin, int pulses_per_rev);
+
+    /** Hold a target RPM rather than a fixed PWM.  Needs at least one tach.
+     *
+     * speed() then sets the target as a fraction of max_rpm.
+     *
+     * @param max_rpm RPM at speed 1.0.  0.0 returns to open loop.
+     * @param gain PWM correction per second for a full scale RPM error
+     */
+    void closed_loop(float max_rpm, float gain);
+
+    /** Trim the PWM towards the target RPM and check for stalls.  Call periodically.
+     *
+     * @param period_s Seconds since the last call
+     */
+    void update(float period_s);
+
+    /** Get the measured RPM, averaged over fans that are turning.  0.0 without tachs. */
+    float rpm(void);
+
+    /** Get the measured RPM of one fan
+     *
+     * @param fan Index in the order tachs were added
+     */
+    float rpm(int fan);
+
+    /** True if any fan with a tach is being driven but not turning */
+    bool stalled(void);
+
+    /** Allow the fan to run below its minimum pwm speed once it is spinning.
+     *
+     * A stopped fan asked for a speed below min_active_pwm is driven at full
+     * speed for kick_time_s, then dropped to the requested speed.
+     *
+     * @param kick_time_s How long to drive the fan flat out when starting from a stop.  0.0 disables.
+     * @param min_running_pwm Lowest speed the fan will hold once it is spinning
+     */
+    void kick_start(float kick_time_s, float min_running_pwm);
+
 protected:
-    PwmOut _pwm;
-    float  _min_active_pwm;
+    PwmOut  _pwm;
+    float   _min_active_pwm;
+    float   _min_running_pwm;
+    float   _kick_time_s;
+    Timeout _kick_timeout;
+    volatile bool  _kicking;   // shared with the kick Timeout ISR
+    volatile float _set_speed;
+    volatile float _drive;     // pwm actually wanted once the kick is over
+
+    FanTach *_tachs[kMaxTachs];
+    int      _num_tachs;
+    Timer    _running_timer;   // time since the fan was started from a stop
+    bool     _stalled;
+    float    _max_rpm;
+    float    _gain;
+    float    _trim;            // learned pwm correction for closed loop
+
+    /* sets the pwm, kick starting if needed */
+    void drive(float pwm, bool starting);
+
+    /* drops a fan out of its kick-start pulse to the requested speed */
+    void end_kick(void);
 };
 
 #endif
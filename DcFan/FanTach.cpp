@@ -0,0 +1,69 @@
+/* Mbed fan tachometer.
+
+Copyright 2020 Jonathan L. Martin <jon.martini@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so, 
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+
+Times a full revolution (pulses_per_rev falling edges) rather than a single
+pulse, so uneven pulse spacing from the hall sensor averages out.
+
+*/
+
+#include "FanTach.h"
+
+#include "mbed.h"
+
+FanTach::FanTach(PinName tach_pin, int pulses_per_rev): _tach_interrupt(tach_pin) {
+    _pulses_per_rev = (pulses_per_rev > 0) ? pulses_per_rev : 1;
+    _pulse_count    = 0;
+    _rev_start_us   = 0;
+    _rev_period_us  = 0;
+    _timer.start();
+    // Tach lines are open collector
+    _tach_interrupt.mode(PullUp);
+    _tach_interrupt.fall(callback(this, &FanTach::pulse));
+}
+
+float FanTach::rpm(float stall_time_s)
+{
+    const uint32_t period_us = _rev_period_us;
+    if ((period_us == 0) || (seconds_since_rev() > stall_time_s))
+    {
+        return 0.0;
+    }
+    return 60.0e6 / float(period_us);
+}
+
+float FanTach::seconds_since_rev(void)
+{
+    // unsigned math handles the Timer wrapping around
+    const uint32_t now_us = (uint32_t)_timer.read_us();
+    return float(now_us - _rev_start_us) / 1.0e6;
+}
+
+void FanTach::pulse()
+{
+    if (++_pulse_count >= _pulses_per_rev)
+    {
+        const uint32_t now_us = (uint32_t)_timer.read_us();
+        _rev_period_us = now_us - _rev_start_us;
+        _rev_start_us  = now_us;
+        _pulse_count   = 0;
+    }
+}
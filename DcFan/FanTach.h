@@ -0,0 +1,85 @@
+/* Mbed fan tachometer.
+
+Copyright 2020 Jonathan L. Martin <jon.martini@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so, 
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+
+Reads the open collector tach line of a 3 or 4 wire fan.  Most PC fans pull
+the line low twice per revolution.
+
+*/
+
+#ifndef MBED_FAN_TACH_H
+#define MBED_FAN_TACH_H
+
+#include "mbed.h"
+
+/** Interface to read the speed of a fan from its tach line
+ *
+ * Example:
+ * @code
+ * //Print the speed of a fan
+ * #include "mbed.h"
+ * #include "FanTach.h"
+ * 
+ * FanTach myTach(p25, 2); // tach pin, pulses per revolution
+ * 
+ * int main() {
+ *     while(1) {
+ *         printf("%5.0f rpm\n", myTach.rpm());
+ *         wait(1.0);
+ *     }
+ * }
+ * @endcode
+ */
+class FanTach {
+public:
+
+    /** Create a fan tachometer
+     *
+     * @param tach_pin - An InterruptIn pin connected to the fan tach line.  Pulled up internally.
+     * @param pulses_per_rev - Tach pulses per revolution of the fan, usually 2
+     */
+    FanTach(PinName tach_pin, int pulses_per_rev);
+
+    /** Get the fan speed measured over the last full revolution
+     *
+     * Reads 0.0 if the fan hasn't completed a revolution within stall_time_s
+     *
+     * @param stall_time_s - Seconds without a full revolution before the fan is considered stopped
+     */
+    float rpm(float stall_time_s = 1.0);
+
+    /** Seconds since the last full revolution was seen */
+    float seconds_since_rev(void);
+
+protected:
+    InterruptIn _tach_interrupt;
+    Timer       _timer;
+    int         _pulses_per_rev;
+    // Set by the ISR, read by methods
+    volatile int      _pulse_count;
+    volatile uint32_t _rev_start_us;
+    volatile uint32_t _rev_period_us;
+
+    /* times each full revolution */
+    void pulse();
+};
+
+#endif
@@ -0,0 +1,272 @@
+/* Mbed DC pump speed control.
+
+Copyright 2020 Jonathan L. Martin <jon.martini@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so, 
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+
+The LPC1768 shares one PWM period across all of its PWM channels, so pumps on
+hardware PWM pins keep whatever period the TECs and fans set.  Software PWM
+runs slow, pump motors don't need more than 100 Hz.
+
+*/
+
+#include "DcPump.h"
+
+#include "mbed.h"
+
+const float kSoftPwmPeriod_s = 0.01;
+const float kRampStep_s      = 0.02;
+
+static bool is_pwm_pin(PinName pin)
+{
+#ifdef MBED_PWMOUT0
+    // The mbed board only brings PWM out to a handful of pins
+    return (pin == MBED_PWMOUT0) || (pin == MBED_PWMOUT1) || (pin == MBED_PWMOUT2) ||
+           (pin == MBED_PWMOUT3) || (pin == MBED_PWMOUT4) || (pin == MBED_PWMOUT5);
+#else
+    return false;
+#endif
+}
+
+DcPump::DcPump(PinName pin, float min_speed, float ramp_per_s) {
+    _pwm = NULL;
+    _out = NULL;
+    if (is_pwm_pin(pin))
+    {
+        _pwm = new PwmOut(pin);
+        *_pwm = 0.0;
+    } else
+    {
+        _out = new DigitalOut(pin, 0);
+    }
+
+    _min_speed      = (min_speed  > 0.0) ? min_speed  : 0.0;
+    _ramp_per_s     = (ramp_per_s > 0.0) ? ramp_per_s : 0.0;
+    _set_speed      = 0.0;
+    _on_s           = 0.0;
+    _off_s          = 0.0;
+    _flow           = NULL;
+    _max_flow_ml_s  = 0.0;
+    _gain           = 0.0;
+    _trim           = 0.0;
+    _last_volume_ml = 0.0;
+    _flow_ml_s      = 0.0;
+    _target         = 0.0;
+    _duty           = 0.0;
+    _level          = 0.0;
+    _pulse_quiet    = false;
+    _soft_running   = false;
+}
+
+bool DcPump::hardware_pwm(void)
+{
+    return _pwm != NULL;
+}
+
+void DcPump::speed(float speed)
+{
+    // Don't allow an invalid speed
+    if (speed > 1.0)
+    {
+        speed = 1.0;
+    }
+    if (speed < _min_speed)
+    {
+        speed = 0.0;
+    }
+    if ((speed == 0.0) || (_set_speed == 0.0))
+    {
+        // Each start relearns the flow trim
+        _trim = 0.0;
+    }
+    _set_speed = speed;
+    drive(speed + _trim);
+}
+
+float DcPump::current_speed(void)
+{
+    return _set_speed;
+}
+
+void DcPump::closed_loop(FlowSensor &flow, float max_flow_ml_s, float gain)
+{
+    _flow           = &flow;
+    _max_flow_ml_s  = (max_flow_ml_s > 0.0) ? max_flow_ml_s : 0.0;
+    _gain           = (gain > 0.0) ? gain : 0.0;
+    _trim           = 0.0;
+    _last_volume_ml = flow.read_total_volume();
+}
+
+void DcPump::update(float period_s)
+{
+    if ((_flow == NULL) || (period_s <= 0.0))
+    {
+        return;
+    }
+
+    // Total volume, so we don't steal counts from other read_volume() users
+    const double volume_ml = _flow->read_total_volume();
+    _flow_ml_s      = float(volume_ml - _last_volume_ml) / period_s;
+    _last_volume_ml = volume_ml;
+
+    // Pulsing flow says nothing useful about the steady state
+    if ((_max_flow_ml_s > 0.0) && (_set_speed > 0.0) && (_off_s == 0.0))
+    {
+        const float error = (_set_speed * _max_flow_ml_s - _flow_ml_s) / _max_flow_ml_s;
+        _trim += _gain * error * period_s;
+        if (_trim > 1.0)
+        {
+            _trim = 1.0;
+        }
+        if (_trim < -1.0)
+        {
+            _trim = -1.0;
+        }
+        drive(_set_speed + _trim);
+    }
+}
+
+float DcPump::flow_ml_s(void)
+{
+    return _flow_ml_s;
+}
+
+void DcPump::pulse(float on_s, float off_s)
+{
+    if ((on_s == _on_s) && (off_s == _off_s))
+    {
+        return; // already pulsing like this, don't restart the cycle
+    }
+    _pulse_ticker.detach();
+    _pulse_off.detach();
+    _on_s  = (on_s  > 0.0) ? on_s  : 0.0;
+    _off_s = (off_s > 0.0) ? off_s : 0.0;
+    if ((_on_s > 0.0) && (_off_s > 0.0))
+    {
+        _pulse_ticker.attach(callback(this, &DcPump::pulse_on), _on_s + _off_s);
+        pulse_on();
+    } else
+    {
+        _off_s = 0.0;
+        _pulse_quiet = false;
+        apply();
+    }
+}
+
+void DcPump::drive(float target)
+{
+    if (_set_speed == 0.0)
+    {
+        target = 0.0;
+    } else if (target > 1.0)
+    {
+        target = 1.0;
+    } else if (target < _min_speed)
+    {
+        target = _min_speed;
+    }
+    // ramp_step() reads _target and _duty from its ticker
+    core_util_critical_section_enter();
+    if (target == _target)
+    {
+        core_util_critical_section_exit();
+        return; // already there or ramping there
+    }
+    _target = target;
+
+    if ((target <= _duty) || (_ramp_per_s == 0.0))
+    {
+        // Slowing down is always safe
+        _ramp_ticker.detach();
+        _duty = target;
+        apply();
+    } else
+    {
+        _ramp_ticker.attach(callback(this, &DcPump::ramp_step), kRampStep_s);
+    }
+    core_util_critical_section_exit();
+}
+
+void DcPump::ramp_step(void)
+{
+    float duty = _duty + _ramp_per_s * kRampStep_s;
+    // Start straight from the minimum speed, anything less won't turn
+    if (duty < _min_speed)
+    {
+        duty = _min_speed;
+    }
+    if (duty >= _target)
+    {
+        duty = _target;
+        _ramp_ticker.detach();
+    }
+    _duty = duty;
+    apply();
+}
+
+void DcPump::apply(void)
+{
+    // Runs from drive() and pulse() and from the ramp and pulse tickers, one
+    // mustn't put a stale level on the pin after the other
+    core_util_critical_section_enter();
+    const float level = _pulse_quiet ? 0.0 : _duty;
+    _level = level;
+
+    if (_pwm != NULL)
+    {
+        *_pwm = level;
+    } else if ((level <= 0.0) || (level >= 1.0))
+    {
+        _soft_pwm_ticker.detach();
+        _soft_pwm_off.detach();
+        _soft_running = false;
+        *_out = (level >= 1.0) ? 1 : 0;
+    } else if (!_soft_running)
+    {
+        _soft_running = true;
+        _soft_pwm_ticker.attach(callback(this, &DcPump::soft_pwm_on), kSoftPwmPeriod_s);
+        soft_pwm_on();
+    }
+    // otherwise the next period picks up the new level
+    core_util_critical_section_exit();
+}
+
+void DcPump::soft_pwm_on(void)
+{
+    *_out = 1;
+    _soft_pwm_off.attach(callback(this, &DcPump::soft_pwm_off), _level * kSoftPwmPeriod_s);
+}
+
+void DcPump::soft_pwm_off(void)
+{
+    *_out = 0;
+}
+
+void DcPump::pulse_on(void)
+{
+    _pulse_quiet = false;
+    apply();
+    _pulse_off.attach(callback(this, &DcPump::pulse_quiet), _on_s);
+}
+
+void DcPump::pulse_quiet(void)
+{
+    _pulse_quiet = true;
+    apply();
+}
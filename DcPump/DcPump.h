@@ -0,0 +1,147 @@
+/* Mbed DC pump speed control.
+
+Copyright 2020 Jonathan L. Martin <jon.martini@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so, 
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+
+Drives a DC pump through an H-bridge or power switch.  Uses hardware PWM if
+the pin supports it, otherwise falls back to software PWM from a Ticker.
+
+*/
+
+#ifndef MBED_DC_PUMP_H
+#define MBED_DC_PUMP_H
+
+#include "mbed.h"
+#include "FlowSensor.h"
+
+/** Interface to control a DC pump.  Soft starts, and optionally holds a
+ * flow rate measured by a FlowSensor.
+ *
+ * Example:
+ * @code
+ * //Hold a shirt pump at 20 mL/s
+ * #include "mbed.h"
+ * #include "DcPump.h"
+ * #include "FlowSensor.h"
+ * 
+ * FlowSensor myFlow(p17, 1.045);
+ * DcPump myPump(p29, 0.3, 0.5); // pin, minimum speed, soft start speed per second
+ * 
+ * int main() {
+ *     myPump.closed_loop(myFlow, 60.0, 0.2); // speed 1.0 = 60 mL/s
+ *     myPump.speed(20.0 / 60.0);
+ *     while(1) {
+ *         myPump.update(1.0);
+ *         wait(1.0);
+ *     }
+ * }
+ * @endcode
+ */
+class DcPump {
+public:
+
+    /** Create a pump control interface
+     *
+     * @param pin - Pin driving the H-bridge enable or power switch.  Any DigitalOut pin works.
+     * @param min_speed - Slowest speed the pump will turn at, speeds below this turn it off
+     * @param ramp_per_s - How quickly the speed may rise, full scale per second.  0.0 disables soft start.
+     */
+    DcPump(PinName pin, float min_speed, float ramp_per_s);
+
+    /** Set the speed of the pump
+     *
+     * @param speed 0.0 to 1.0.  In closed loop this is the fraction of max_flow to hold.
+     */
+    void speed(float speed);
+
+    /** Get the speed requested, does *not* read the flow */
+    float current_speed(void);
+
+    /** Hold a flow rate rather than a fixed speed
+     *
+     * @param flow The flow sensor in this pump's loop
+     * @param max_flow_ml_s Flow at speed 1.0 in mL/s.  0.0 returns to open loop.
+     * @param gain Speed correction per second for a full scale flow error
+     */
+    void closed_loop(FlowSensor &flow, float max_flow_ml_s, float gain);
+
+    /** Pulse the pump on and off, useful for bleeding air out of a loop
+     *
+     * @param on_s Seconds at speed
+     * @param off_s Seconds off.  0.0 stops pulsing.
+     */
+    void pulse(float on_s, float off_s);
+
+    /** Trim the speed towards the flow target.  Call periodically.
+     *
+     * @param period_s Seconds since the last call
+     */
+    void update(float period_s);
+
+    /** Get the flow measured by the last update() in mL/s */
+    float flow_ml_s(void);
+
+    /** True if the pin has hardware PWM */
+    bool hardware_pwm(void);
+
+protected:
+    PwmOut     *_pwm;      // one of these two is used
+    DigitalOut *_out;
+    Ticker      _soft_pwm_ticker;
+    Timeout     _soft_pwm_off;
+    Ticker      _ramp_ticker;
+    Ticker      _pulse_ticker;
+    Timeout     _pulse_off;
+
+    float _min_speed;
+    float _ramp_per_s;
+    float _set_speed;
+    float _on_s;
+    float _off_s;
+
+    FlowSensor *_flow;
+    float       _max_flow_ml_s;
+    float       _gain;
+    float       _trim;
+    double      _last_volume_ml;
+    float       _flow_ml_s;
+
+    // Shared with ISRs
+    volatile float _target;     // speed the ramp is heading for
+    volatile float _duty;       // ramped speed
+    volatile float _level;      // what is actually on the pin
+    volatile bool  _pulse_quiet;
+    volatile bool  _soft_running;
+
+    /* puts _duty on the pin, honoring the pulse off time */
+    void apply(void);
+    /* sets the target, ramping up or dropping straight down */
+    void drive(float target);
+    /* steps _duty towards _target */
+    void ramp_step(void);
+    /* software pwm edges */
+    void soft_pwm_on(void);
+    void soft_pwm_off(void);
+    /* bleed pulse edges */
+    void pulse_on(void);
+    void pulse_quiet(void);
+};
+
+#endif
@@ -0,0 +1,177 @@
+/* Mbed display update scheduler for the uLCD-144-G2.
+
+Copyright 2020 Jonathan L. Martin <jon.martini@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so, 
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+
+Widget refresh is counted in frames rather than seconds so the schedule is
+not upset by the Timer wrapping.  A widget's cost is what it really sent the
+last time it drew, read back from uLCD_4DGL::bytes_sent.
+
+*/
+
+#include "DisplayScheduler.h"
+
+#include "mbed.h"
+
+DisplayScheduler::DisplayScheduler(uLCD_4DGL &lcd, float frame_period_s, int baud, float budget_fraction):
+    _lcd(lcd) {
+    _frame_period_s  = frame_period_s;
+    _budget_fraction = budget_fraction;
+    _num_widgets     = 0;
+    _deferred        = 0;
+    baudrate(baud);
+}
+
+void DisplayScheduler::baudrate(int baud)
+{
+    // Start bit, 8 data bits, stop bit
+    _budget_bytes = (int)(baud / 10.0 * _frame_period_s * _budget_fraction);
+    if (_budget_bytes < 1)
+    {
+        _budget_bytes = 1;
+    }
+}
+
+int DisplayScheduler::add(Callback<void()> draw, int priority, float interval_s)
+{
+    if (_num_widgets >= kMaxWidgets)
+    {
+        return -1;
+    }
+    Widget &widget = _widgets[_num_widgets];
+    widget.draw            = draw;
+    widget.priority        = priority;
+    widget.interval_frames = 0;
+    if (interval_s > 0.0)
+    {
+        widget.interval_frames = (int)(interval_s / _frame_period_s + 0.5);
+        if (widget.interval_frames < 1)
+        {
+            widget.interval_frames = 1;
+        }
+    }
+    widget.age_frames    = 0;
+    widget.waited_frames = 0;
+    widget.cost_bytes    = 0;
+    widget.marked        = true; // draw everything once
+    return _num_widgets++;
+}
+
+void DisplayScheduler::mark(int widget)
+{
+    if ((widget >= 0) && (widget < _num_widgets))
+    {
+        _widgets[widget].marked = true;
+    }
+}
+
+void DisplayScheduler::mark_all(void)
+{
+    for (int i = 0; i < _num_widgets; i++)
+    {
+        _widgets[i].marked = true;
+    }
+}
+
+bool DisplayScheduler::due(const Widget &widget)
+{
+    return widget.marked ||
+           ((widget.interval_frames > 0) && (widget.age_frames >= widget.interval_frames));
+}
+
+void DisplayScheduler::run_frame(void)
+{
+    const float kBudget_s = _frame_period_s * _budget_fraction;
+    bool        drawn[kMaxWidgets] = {false};
+    int         spent_bytes = 0;
+
+    _frame_timer.reset();
+    _frame_timer.start();
+
+    // Highest effective priority first, a selection sort over a handful of widgets
+    while (1)
+    {
+        int best = -1;
+        for (int i = 0; i < _num_widgets; i++)
+        {
+            if (drawn[i] || !due(_widgets[i]))
+            {
+                continue;
+            }
+            if ((best < 0) ||
+                (_widgets[i].priority + _widgets[i].waited_frames >
+                 _widgets[best].priority + _widgets[best].waited_frames))
+            {
+                best = i;
+            }
+        }
+        if (best < 0)
+        {
+            break;
+        }
+
+        Widget &widget = _widgets[best];
+        const bool first = (spent_bytes == 0);
+        if (!first &&
+            ((spent_bytes + widget.cost_bytes > _budget_bytes) ||
+             (_frame_timer.read() >= kBudget_s)))
+        {
+            break;
+        }
+
+        const unsigned int start_bytes = _lcd.bytes_sent;
+        widget.marked = false;
+        widget.draw();
+        widget.cost_bytes    = _lcd.bytes_sent - start_bytes;
+        widget.age_frames    = 0;
+        widget.waited_frames = 0;
+        drawn[best]  = true;
+        spent_bytes += widget.cost_bytes;
+        if (spent_bytes == 0)
+        {
+            spent_bytes = 1; // drew nothing, but this is no longer the first widget
+        }
+    }
+    _frame_timer.stop();
+
+    for (int i = 0; i < _num_widgets; i++)
+    {
+        if (drawn[i])
+        {
+            continue;
+        }
+        _widgets[i].age_frames++;
+        if (due(_widgets[i]))
+        {
+            _widgets[i].waited_frames++;
+            _deferred++;
+        }
+    }
+}
+
+int DisplayScheduler::budget_bytes(void)
+{
+    return _budget_bytes;
+}
+
+unsigned int DisplayScheduler::deferred(void)
+{
+    return _deferred;
+}
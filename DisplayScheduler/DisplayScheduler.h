@@ -0,0 +1,141 @@
+/* Mbed display update scheduler for the uLCD-144-G2.
+
+Copyright 2020 Jonathan L. Martin <jon.martini@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so, 
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+
+Runs display widgets by priority and refresh interval inside a per frame
+byte and time budget, so a busy screen never blocks for longer than planned.
+
+*/
+
+#ifndef MBED_DISPLAY_SCHEDULER_H
+#define MBED_DISPLAY_SCHEDULER_H
+
+#include "mbed.h"
+#include "uLCD_4DGL.h"
+
+/** Interface to schedule uLCD_4DGL drawing
+ *
+ * Each frame the due widgets are drawn highest priority first until the
+ * frame's budget is spent.  Anything left over rolls over to the next frame
+ * and gains a step of priority for every frame it waits, so low priority
+ * widgets are delayed but never starved.  The first widget drawn in a frame
+ * always runs, even when it costs more than the whole budget.
+ *
+ * Example:
+ * @code
+ * // Refresh a clock once a second at 115200 baud
+ * #include "mbed.h"
+ * #include "uLCD_4DGL.h"
+ * #include "DisplayScheduler.h"
+ * 
+ * uLCD_4DGL uLCD(p13,p14,p15);
+ * 
+ * // lcd, frame period s, baud, fraction of the frame to spend drawing
+ * DisplayScheduler myScheduler(uLCD, 0.1, 115200, 0.5);
+ * 
+ * void DrawClock() {
+ *     uLCD.locate(0,0);
+ *     uLCD.printf("%d", time(NULL));
+ * }
+ * 
+ * int main() {
+ *     uLCD.baudrate(115200);
+ *     myScheduler.add(DrawClock, 1, 1.0); // widget, priority, interval s
+ *     while(1) {
+ *         myScheduler.run_frame();
+ *         wait(0.1);
+ *     }
+ * }
+ * @endcode
+ */
+class DisplayScheduler {
+public:
+
+    enum { kMaxWidgets = 8 };
+
+    /** Create a display scheduler
+     *
+     * @param lcd - The display the widgets draw on
+     * @param frame_period_s - How often run_frame() is called
+     * @param baud - Display baud rate, sets the byte budget
+     * @param budget_fraction - Share of each frame the display may use, 0.0 to 1.0
+     */
+    DisplayScheduler(uLCD_4DGL &lcd, float frame_period_s, int baud, float budget_fraction = 0.5);
+
+    /** Recompute the byte budget after a uLCD_4DGL::baudrate() change
+     *
+     * @param baud - Display baud rate
+     */
+    void baudrate(int baud);
+
+    /** Add a widget
+     *
+     * @param draw - Draws the widget, must only touch the display passed to the constructor
+     * @param priority - Higher draws first
+     * @param interval_s - Refresh interval, 0.0 to draw only when marked
+     * @returns The widget number for mark(), or -1 if there are already kMaxWidgets
+     */
+    int add(Callback<void()> draw, int priority, float interval_s);
+
+    /** Draw a widget on the next frame, e.g. when its content changed
+     *
+     * Safe to call from another thread.
+     *
+     * @param widget - Widget number from add()
+     */
+    void mark(int widget);
+
+    /** Mark every widget, e.g. after a cls() */
+    void mark_all(void);
+
+    /** Draw the due widgets that fit in this frame's budget */
+    void run_frame(void);
+
+    /** Bytes each frame may send */
+    int budget_bytes(void);
+
+    /** Widgets rolled over to a later frame since start up */
+    unsigned int deferred(void);
+
+protected:
+    struct Widget {
+        Callback<void()> draw;
+        int              priority;
+        int              interval_frames; // 0 only when marked
+        int              age_frames;      // frames since last drawn
+        int              waited_frames;   // frames spent due but not drawn
+        int              cost_bytes;      // bytes sent the last time it was drawn
+        volatile bool    marked;
+    };
+
+    bool due(const Widget &widget);
+
+    uLCD_4DGL   &_lcd;
+    float        _frame_period_s;
+    float        _budget_fraction;
+    int          _budget_bytes;
+    int          _num_widgets;
+    Widget       _widgets[kMaxWidgets];
+    Timer        _frame_timer;
+    unsigned int _deferred;
+};
+
+#endif
@@ -0,0 +1,99 @@
+/* Mbed fan curve for a DcFan.
+
+Copyright 2020 Jonathan L. Martin <jon.martini@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so, 
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+
+Hysteresis works like mechanical backlash: a rising delta drags the curve
+input up with it, a falling delta has to drop a full hysteresis band before
+the curve input follows.  Small temperature wobbles leave the fan alone.
+
+*/
+
+#include "FanCurve.h"
+
+#include "mbed.h"
+
+FanCurve::FanCurve(DcFan &fan, const Point *points, int num_points, float hysteresis_C, float full_power_speed):
+    _fan(fan) {
+    _points           = points;
+    _num_points       = num_points;
+    _hysteresis_C     = (hysteresis_C > 0.0) ? hysteresis_C : 0.0;
+    _full_power_speed = full_power_speed;
+    _held_delta_C     = 0.0;
+}
+
+float FanCurve::curve_speed(float delta_C)
+{
+    if (_num_points <= 0)
+    {
+        return 0.0;
+    }
+    if (delta_C <= _points[0].delta_C)
+    {
+        return _points[0].speed;
+    }
+    for (int i = 1; i < _num_points; i++)
+    {
+        if (delta_C < _points[i].delta_C)
+        {
+            const Point &lo = _points[i - 1];
+            const Point &hi = _points[i];
+            return lo.speed + 
+                   (hi.speed - lo.speed) * (delta_C - lo.delta_C) / (hi.delta_C - lo.delta_C);
+        }
+    }
+    return _points[_num_points - 1].speed;
+}
+
+float FanCurve::update(TEC::TecAction action, float radiator_C, float ambient_C, float tec_power_percent)
+{
+    // Signed so the curve only rises as the TECs push the radiator further
+    float delta_C = (action == TEC::Heating) ? ambient_C - radiator_C : radiator_C - ambient_C;
+    if (delta_C < 0.0)
+    {
+        delta_C = 0.0;
+    }
+
+    if (delta_C > _held_delta_C)
+    {
+        _held_delta_C = delta_C;
+    } else if (delta_C < _held_delta_C - _hysteresis_C)
+    {
+        _held_delta_C = delta_C + _hysteresis_C;
+    }
+
+    float speed = curve_speed(_held_delta_C);
+
+    // Heat pumped into the radiator shows up before the radiator warms up
+    const float power_speed = _full_power_speed * tec_power_percent / 100.0;
+    if (power_speed > speed)
+    {
+        speed = power_speed;
+    }
+
+    _fan.speed(speed);
+    return _fan.current_speed();
+}
+
+void FanCurve::off(void)
+{
+    _held_delta_C = 0.0;
+    _fan.speed(0.0);
+}
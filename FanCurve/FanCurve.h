@@ -0,0 +1,115 @@
+/* Mbed fan curve for a DcFan.
+
+Copyright 2020 Jonathan L. Martin <jon.martini@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so, 
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+
+Drives a DcFan from a piecewise-linear curve of how far the TECs have pushed
+the radiator from ambient, with a floor set by how hard they are working.
+
+*/
+
+#ifndef MBED_FAN_CURVE_H
+#define MBED_FAN_CURVE_H
+
+#include "mbed.h"
+#include "DcFan.h"
+#include "TEC.h"
+
+/** Interface to run a DcFan off of a temperature curve
+ *
+ * Example:
+ * @code
+ * //Scale fan speed with how far the radiator is above ambient
+ * #include "mbed.h"
+ * #include "DcFan.h"
+ * #include "FanCurve.h"
+ * 
+ * DcFan myFans(p26, 0.5); // pwm, minimum pwm speed
+ * 
+ * // degrees C over ambient, fan speed 0.0 to 1.0
+ * const FanCurve::Point myCurve[] = 
+ *   {{ 2.0, 0.0},
+ *    { 3.0, 0.3},
+ *    {10.0, 1.0}};
+ * 
+ * // fan, curve, points, hysteresis C, speed at full TEC power
+ * FanCurve myFanCurve(myFans, myCurve, 3, 1.0, 0.5);
+ * 
+ * int main() {
+ *     while(1) {
+ *         myFanCurve.update(TEC::Cooling, radiator_C, 25.0, tec_percent);
+ *         wait(1.0);
+ *     }
+ * }
+ * @endcode
+ */
+class FanCurve {
+public:
+
+    /** One point on the fan curve */
+    struct Point {
+        float delta_C; // Radiator degrees C pushed from ambient
+        float speed;   // Fan speed 0.0 to 1.0
+    };
+
+    /** Create a fan curve
+     *
+     * @param fan - The fan to drive
+     * @param points - Curve points, sorted by increasing delta_C.  Not copied, must stay valid.
+     * @param num_points - Number of points in the curve
+     * @param hysteresis_C - How far the delta must fall before the fan slows back down
+     * @param full_power_speed - Minimum fan speed with the TECs at 100% power, scaled down linearly with power
+     */
+    FanCurve(DcFan &fan, const Point *points, int num_points, float hysteresis_C, float full_power_speed);
+
+    /** Set the fan speed from the current temperatures
+     *
+     * Cooling dumps heat into the radiator, so the curve is keyed on how far
+     * it is above ambient; heating pulls heat out of the air, so on how far
+     * it is below.  A radiator on the other side of ambient is helping and
+     * only gets the TEC power floor.
+     *
+     * @param action - What the TECs are doing to the shirt loop
+     * @param radiator_C - Radiator temperature in C
+     * @param ambient_C - Ambient air temperature in C
+     * @param tec_power_percent - TEC power 0.0 to 100.0
+     * @returns The fan speed requested, 0.0 to 1.0
+     */
+    float update(TEC::TecAction action, float radiator_C, float ambient_C, float tec_power_percent);
+
+    /** Turn the fan off and forget the hysteresis history */
+    void off(void);
+
+    /** Look up the curve without hysteresis or the TEC power floor
+     *
+     * @param delta_C - Radiator degrees C pushed from ambient
+     */
+    float curve_speed(float delta_C);
+
+protected:
+    DcFan       &_fan;
+    const Point *_points;
+    int          _num_points;
+    float        _hysteresis_C;
+    float        _full_power_speed;
+    float        _held_delta_C; // delta after hysteresis
+};
+
+#endif
@@ -0,0 +1,143 @@
+/* Mbed settings in the LPC1768's own flash
+
+Copyright 2020 Jonathan L. Martin <jon.martini@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so, 
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+
+IAP commands from the LPC17xx user manual, UM10360 chapter 32.  The ROM
+uses the top 32 bytes of RAM as scratch.  The linker script doesn't reserve
+them; they are the top of the handler (MSP) stack that RTX leaves above the
+main thread's stack, where only the frames of the startup code, which never
+returns, are kept.  Threads run on their own stacks, so calling IAP from
+thread mode with interrupts off leaves that stack idle while the ROM runs.
+
+*/
+
+#include "FlashStore.h"
+#include <string.h>
+
+#define IAP_LOCATION 0x1FFF1FF1
+#define IAP_PREPARE  50
+#define IAP_COPY     51
+#define IAP_ERASE    52
+#define IAP_SUCCESS  0
+
+#define WRITE_SIZE   256     // smallest block COPY will program
+
+typedef void (*IapEntry)(uint32_t *command, uint32_t *result);
+
+// Saved ahead of the settings
+struct FlashStoreHeader {
+    uint32_t magic;
+    uint32_t size;
+    uint32_t crc;
+};
+
+FlashStore::FlashStore(uint32_t magic, uint32_t address) {
+    _magic   = magic;
+    _address = address;
+    // 16 sectors of 4 KB then 14 of 32 KB
+    if (address < 0x10000) {
+        _sector = address / 0x1000;
+    } else {
+        _sector = 16 + (address - 0x10000) / 0x8000;
+    }
+}
+
+bool FlashStore::load(void *data, int size) {
+    const FlashStoreHeader *header = (const FlashStoreHeader *)(uintptr_t)_address;
+    const uint8_t          *saved  = (const uint8_t *)(uintptr_t)(_address + sizeof(FlashStoreHeader));
+    if ((header->magic != _magic) || (header->size != (uint32_t)size) || (size > kMaxSize)) {
+        return false;
+    }
+    if (header->crc != crc32(saved, size)) {
+        return false;
+    }
+    memcpy(data, saved, size);
+    return true;
+}
+
+bool FlashStore::save(const void *data, int size) {
+    if ((size < 0) || (size > kMaxSize)) {
+        return false;
+    }
+    // COPY takes word aligned RAM, a block at a time
+    static uint32_t block[WRITE_SIZE / 4];
+    uint8_t *bytes = (uint8_t *)block;
+
+    FlashStoreHeader header;
+    header.magic = _magic;
+    header.size  = size;
+    header.crc   = crc32((const uint8_t *)data, size);
+
+    if (!erase()) {
+        return false;
+    }
+    const int total = sizeof(header) + size;
+    for (int offset = 0; offset < total; offset += WRITE_SIZE) {
+        memset(bytes, 0xFF, WRITE_SIZE);
+        for (int i = 0; (i < WRITE_SIZE) && (offset + i < total); i++) {
+            const int n = offset + i;
+            bytes[i] = (n < (int)sizeof(header)) ? ((const uint8_t *)&header)[n]
+                                                 : ((const uint8_t *)data)[n - sizeof(header)];
+        }
+        if ((iap(IAP_PREPARE, _sector, _sector, 0, 0) != IAP_SUCCESS) ||
+            (iap(IAP_COPY, _address + offset, (uint32_t)(uintptr_t)block, WRITE_SIZE, SystemCoreClock / 1000) != IAP_SUCCESS)) {
+            return false;
+        }
+    }
+    // Flash is memory mapped, check what landed there
+    const FlashStoreHeader *saved = (const FlashStoreHeader *)(uintptr_t)_address;
+    return (memcmp(saved, &header, sizeof(header)) == 0) &&
+           (memcmp(saved + 1, data, size) == 0);
+}
+
+bool FlashStore::erase(void) {
+    return (iap(IAP_PREPARE, _sector, _sector, 0, 0) == IAP_SUCCESS) &&
+           (iap(IAP_ERASE, _sector, _sector, SystemCoreClock / 1000, 0) == IAP_SUCCESS);
+}
+
+int FlashStore::iap(uint32_t command, uint32_t p1, uint32_t p2, uint32_t p3, uint32_t p4) {
+    uint32_t params[5] = {command, p1, p2, p3, p4};
+    uint32_t result[5];
+    const IapEntry entry = (IapEntry)IAP_LOCATION;
+    // The ROM's scratch RAM is the handler stack, only idle in thread mode
+    if (__get_IPSR() != 0) {
+        return -1;
+    }
+    // Handlers live in flash, which can't be read while it is busy
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    entry(params, result);
+    if (primask == 0) {
+        __enable_irq();
+    }
+    return result[0];
+}
+
+uint32_t FlashStore::crc32(const uint8_t *data, int size) {
+    uint32_t crc = 0xFFFFFFFF;
+    for (int i = 0; i < size; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
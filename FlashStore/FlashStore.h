@@ -0,0 +1,107 @@
+/* Mbed settings in the LPC1768's own flash
+
+Copyright 2020 Jonathan L. Martin <jon.martini@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so, 
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+
+Keeps one small block of settings in a flash sector through the LPC1768's
+In-Application Programming ROM calls.  The block carries a magic number, its
+size and a CRC, so an erased sector, a half written one or one from a build
+with a different layout all read back as nothing saved.
+
+Erasing and programming stall the flash, and with it every interrupt
+handler, for up to ~100 ms with interrupts off.  Only save from something
+the user asked for, never from the control loop.
+
+The default sector is the last 32 KB one, 0x78000, so the program image must
+stay under 480 KB.
+
+*/
+
+#ifndef MBED_FLASH_STORE_H
+#define MBED_FLASH_STORE_H
+
+#include "mbed.h"
+
+/** One block of settings in internal flash
+ *
+ * Example:
+ * @code
+ * // Remember a setting across power cycles
+ * #include "mbed.h"
+ * #include "FlashStore.h"
+ * 
+ * struct Settings {
+ *     int32_t setpoint_cC;
+ * };
+ * 
+ * FlashStore store(0x50434301);   // magic, change it when Settings changes
+ * 
+ * int main() {
+ *     Settings settings;
+ *     if (!store.load(&settings, sizeof(settings))) {
+ *         settings.setpoint_cC = 2550;
+ *     }
+ *     settings.setpoint_cC += 50;
+ *     store.save(&settings, sizeof(settings));
+ * }
+ * @endcode
+ */
+class FlashStore {
+public:
+
+    enum { kLastSector = 0x78000 };
+    enum { kMaxSize = 1024 - 12 };   // settings bytes, less the header
+
+    /** Create a store, nothing is read until load()
+     *
+     * @param magic - Identifies the layout of what is saved
+     * @param address - Start of the flash sector to use, the whole sector is erased on save
+     */
+    FlashStore(uint32_t magic, uint32_t address = kLastSector);
+
+    /** Read the settings back
+     *
+     * @param data - Where to copy them
+     * @param size - Their size, must match what was saved
+     * @returns true if a valid block of that size was found
+     */
+    bool load(void *data, int size);
+
+    /** Erase the sector and write the settings, interrupts are off throughout
+     *
+     * @param data - Settings to save
+     * @param size - Their size, up to kMaxSize
+     * @returns true if they read back correctly
+     */
+    bool save(const void *data, int size);
+
+    /** Erase the sector, load() finds nothing after */
+    bool erase(void);
+
+protected:
+    uint32_t _magic;
+    uint32_t _address;
+    int      _sector;
+
+    static uint32_t crc32(const uint8_t *data, int size);
+    int iap(uint32_t command, uint32_t p1, uint32_t p2, uint32_t p3, uint32_t p4);
+};
+
+#endif
@@ -0,0 +1,132 @@
+/* Mbed float free text formatting
+
+Copyright 2020 Jonathan L. Martin <jon.martini@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so, 
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+
+*/
+
+#include "Formatter.h"
+
+static const uint32_t kPowersOf10[10] =
+   {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+
+Formatter::Formatter(char *buffer, int size) {
+    _buffer = buffer;
+    _size   = size;
+    clear();
+}
+
+void Formatter::clear(void) {
+    _length    = 0;
+    _truncated = false;
+    if (_size > 0) {
+        _buffer[0] = '\0';
+    }
+}
+
+Formatter &Formatter::put(char c) {
+    if (_length < _size - 1) {
+        _buffer[_length++] = c;
+        _buffer[_length]   = '\0';
+    } else {
+        _truncated = true;
+    }
+    return *this;
+}
+
+Formatter &Formatter::text(const char *s, int width) {
+    while (*s != '\0') {
+        put(*s++);
+        width--;
+    }
+    while (width-- > 0) {
+        put(' ');
+    }
+    return *this;
+}
+
+Formatter &Formatter::dec(int32_t value, int width) {
+    const uint32_t magnitude = (value < 0) ? (uint32_t)0 - (uint32_t)value : (uint32_t)value;
+    append_digits(magnitude, value < 0, 0, width);
+    return *this;
+}
+
+Formatter &Formatter::fixed(int32_t value, int scale, int decimals, int width) {
+    uint32_t magnitude = (value < 0) ? (uint32_t)0 - (uint32_t)value : (uint32_t)value;
+
+    if (scale < 0) {
+        scale = 0;
+    }
+    if (scale > 9) {
+        scale = 9;
+    }
+    if (decimals < 0) {
+        decimals = 0;
+    }
+    if (decimals > 9) {
+        decimals = 9;
+    }
+
+    // Drop the digits that aren't shown, rounding half away from zero.
+    // Extra decimals beyond scale are zeros, appended after the point below.
+    int shown = (decimals < scale) ? decimals : scale;
+    if (shown < scale) {
+        const uint32_t divisor = kPowersOf10[scale - shown];
+        magnitude = (magnitude / divisor) + (((magnitude % divisor) >= ((divisor + 1) / 2)) ? 1 : 0);
+    }
+    const int zeros = decimals - shown;
+    const int extra = (zeros > 0) ? zeros + ((shown == 0) ? 1 : 0) : 0;
+    append_digits(magnitude, (value < 0) && (magnitude != 0), shown, width - extra);
+    if ((zeros > 0) && (shown == 0)) {
+        put('.');
+    }
+    for (int i = 0; i < zeros; i++) {
+        put('0');
+    }
+    return *this;
+}
+
+void Formatter::append_digits(uint32_t magnitude, bool negative, int decimals, int width) {
+    // Least significant first, then copied out reversed
+    char digits[16];
+    int  n = 0;
+
+    for (int i = 0; i < decimals; i++) {
+        digits[n++] = '0' + (magnitude % 10);
+        magnitude /= 10;
+    }
+    if (decimals > 0) {
+        digits[n++] = '.';
+    }
+    do {
+        digits[n++] = '0' + (magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+    if (negative) {
+        digits[n++] = '-';
+    }
+
+    for (int pad = width - n; pad > 0; pad--) {
+        put(' ');
+    }
+    while (n > 0) {
+        put(digits[--n]);
+    }
+}
@@ -0,0 +1,120 @@
+/* Mbed float free text formatting
+
+Copyright 2020 Jonathan L. Martin <jon.martini@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so, 
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+
+Builds short lines of text in a caller's buffer without printf.  Any %f
+anywhere in a build links the soft float vfprintf, many KB of flash, and
+every call walks the format string and converts through double.  The
+telemetry and display lines only ever need integers, fixed point values and
+padding, which this does with integer divides.
+
+*/
+
+#ifndef MBED_FORMATTER_H
+#define MBED_FORMATTER_H
+
+#include "mbed.h"
+
+/** Float free, heap free line formatter
+ *
+ * Appends go to the end of the buffer, which is always NUL terminated.
+ * Output that doesn't fit is cut off and truncated() reports it.
+ *
+ * Example:
+ * @code
+ * // "Shirt  23.5oC  45%" without printf
+ * #include "mbed.h"
+ * #include "Formatter.h"
+ * 
+ * int main() {
+ *     char buffer[24];
+ *     Formatter line(buffer, sizeof(buffer));
+ *     int32_t shirt_cC = 2347;   // hundredths of a degree
+ *     line.text("Shirt", 6).fixed(shirt_cC, 2, 1, 5).text("oC").dec(45, 4).put('%');
+ *     puts(line.c_str());
+ * }
+ * @endcode
+ */
+class Formatter {
+public:
+
+    /** Create a formatter writing to buffer, starting empty
+     *
+     * @param buffer - Where the text goes
+     * @param size - Size of buffer including the NUL
+     */
+    Formatter(char *buffer, int size);
+
+    /** Append one character */
+    Formatter &put(char c);
+
+    /** Append a string, left aligned and padded with spaces to width
+     *
+     * @param s - NUL terminated string
+     * @param width - Minimum characters, 0 for none
+     */
+    Formatter &text(const char *s, int width = 0);
+
+    /** Append an integer, right aligned like printf("%*d")
+     *
+     * @param value - The integer
+     * @param width - Minimum characters, padded on the left with spaces
+     */
+    Formatter &dec(int32_t value, int width = 0);
+
+    /** Append a fixed point value, right aligned like printf("%*.*f")
+     *  Rounds half away from zero and never writes "-0.0".
+     *
+     * @param value - The value in units of 10^-scale, e.g. 2347 with scale 2 is 23.47
+     * @param scale - Decimal digits held in value, 0 to 9
+     * @param decimals - Places after the point to show, 0 to 9
+     * @param width - Minimum characters, padded on the left with spaces
+     */
+    Formatter &fixed(int32_t value, int scale, int decimals, int width = 0);
+
+    /** The text so far */
+    const char *c_str(void) const {
+        return _buffer;
+    }
+
+    /** Characters so far, not counting the NUL */
+    int length(void) const {
+        return _length;
+    }
+
+    /** True if anything was cut off */
+    bool truncated(void) const {
+        return _truncated;
+    }
+
+    /** Start again with an empty buffer */
+    void clear(void);
+
+protected:
+    void append_digits(uint32_t magnitude, bool negative, int decimals, int width);
+
+    char *_buffer;
+    int   _size;
+    int   _length;
+    bool  _truncated;
+};
+
+#endif
@@ -0,0 +1,143 @@
+/* Mbed PID controllers on CMSIS-DSP kernels
+
+Copyright 2020 Jonathan L. Martin <jon.martini@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so, 
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+
+*/
+
+#include "Pid.h"
+#include <math.h>
+
+PidDesign::PidDesign(float kp, float ki, float kd, float period_s, temp_cC range_cC) {
+    const float kd_T = kd / period_s;
+    _a[0]     = kp + (ki * period_s) + kd_T;
+    _a[1]     = -kp - (2.0f * kd_T);
+    _a[2]     = kd_T;
+    _range_cC = (range_cC > 0) ? range_cC : 1;
+
+    // Full scale input is 4 x range_cC.  Shift the output scale up until
+    // the gains, and so the accumulator, stay below 1.
+    const float sum     = fabsf(_a[0]) + fabsf(_a[1]) + fabsf(_a[2]);
+    const float in_fs_C = 4.0f * _range_cC / 100.0f;
+    _out_shift = 1;
+    while ((_out_shift < 14) && (sum * in_fs_C >= 100.0f * (1 << _out_shift))) {
+        _out_shift++;
+    }
+}
+
+PidF32::PidF32(float kp, float ki, float kd, float period_s, temp_cC range_cC):
+    PidDesign(kp, ki, kd, period_s, range_cC) {
+    _pid.A0 = _a[0];
+    _pid.A1 = _a[1];
+    _pid.A2 = _a[2];
+    _pid.Kp = kp;
+    _pid.Ki = ki;
+    _pid.Kd = kd;
+    reset(0, 0);
+}
+
+void PidF32::reset(temp_cC error_cC, int32_t power) {
+    const float error_C = clamp(error_cC) / 100.0f;
+    _pid.state[0] = error_C;
+    _pid.state[1] = error_C;
+    _pid.state[2] = power / 100.0f;
+}
+
+int32_t PidF32::update(temp_cC error_cC) {
+    float percent = arm_pid_f32(&_pid, clamp(error_cC) / 100.0f);
+    if (percent < 0.0f) {
+        percent = 0.0f;
+    } else if (percent > 100.0f) {
+        percent = 100.0f;
+    }
+    _pid.state[2] = percent;
+    return (int32_t)(percent * 100.0f + 0.5f);
+}
+
+// One gain in % per C as Q(bits), output full scale 100% << out_shift
+static int32_t fixed_gain(float a, temp_cC range_cC, int out_shift, int bits) {
+    const float limit = (float)((1UL << bits) - 1);
+    float q = a * (4.0f * range_cC / 100.0f) / (100.0f * (1 << out_shift)) * (float)(1UL << bits);
+    q = (q > limit) ? limit : (q < -limit) ? -limit : q;
+    return (int32_t)((q < 0) ? q - 0.5f : q + 0.5f);
+}
+
+PidQ31::PidQ31(float kp, float ki, float kd, float period_s, temp_cC range_cC):
+    PidDesign(kp, ki, kd, period_s, range_cC) {
+    _pid.A0   = fixed_gain(_a[0], _range_cC, _out_shift, 31);
+    _pid.A1   = fixed_gain(_a[1], _range_cC, _out_shift, 31);
+    _pid.A2   = fixed_gain(_a[2], _range_cC, _out_shift, 31);
+    _pid.Kp   = 0;   // only A0 - A2 are used by the kernel
+    _pid.Ki   = 0;
+    _pid.Kd   = 0;
+    _in_scale = (1L << 29) / _range_cC;
+    _out_full = (q31_t)(1UL << (31 - _out_shift));
+    reset(0, 0);
+}
+
+void PidQ31::reset(temp_cC error_cC, int32_t power) {
+    const q31_t error = clamp(error_cC) * _in_scale;
+    _pid.state[0] = error;
+    _pid.state[1] = error;
+    _pid.state[2] = (q31_t)(((int64_t)power << (31 - _out_shift)) / kPowerFull);
+}
+
+int32_t PidQ31::update(temp_cC error_cC) {
+    q31_t y = arm_pid_q31(&_pid, clamp(error_cC) * _in_scale);
+    if (y < 0) {
+        y = 0;
+    } else if (y > _out_full) {
+        y = _out_full;
+    }
+    _pid.state[2] = y;
+    return (int32_t)(((int64_t)y * kPowerFull) >> (31 - _out_shift));
+}
+
+PidQ15::PidQ15(float kp, float ki, float kd, float period_s, temp_cC range_cC):
+    PidDesign(kp, ki, kd, period_s, range_cC) {
+    const int32_t a1 = fixed_gain(_a[1], _range_cC, _out_shift, 15);
+    const int32_t a2 = fixed_gain(_a[2], _range_cC, _out_shift, 15);
+    _pid.A0   = (q15_t)fixed_gain(_a[0], _range_cC, _out_shift, 15);
+    _pid.A1   = __PKHBT(a1, a2, 16);   // A1 low, A2 high, for the dual multiply
+    _pid.Kp   = 0;
+    _pid.Ki   = 0;
+    _pid.Kd   = 0;
+    _in_scale = (1L << 29) / _range_cC;
+    _out_full = (q15_t)(1 << (15 - _out_shift));
+    reset(0, 0);
+}
+
+void PidQ15::reset(temp_cC error_cC, int32_t power) {
+    const q15_t error = (q15_t)((clamp(error_cC) * _in_scale) >> 16);
+    _pid.state[0] = error;
+    _pid.state[1] = error;
+    _pid.state[2] = (q15_t)((power << (15 - _out_shift)) / kPowerFull);
+}
+
+int32_t PidQ15::update(temp_cC error_cC) {
+    q15_t y = arm_pid_q15(&_pid, (q15_t)((clamp(error_cC) * _in_scale) >> 16));
+    if (y < 0) {
+        y = 0;
+    } else if (y > _out_full) {
+        y = _out_full;
+    }
+    _pid.state[2] = y;
+    return ((int32_t)y * kPowerFull) >> (15 - _out_shift);
+}
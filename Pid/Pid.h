@@ -0,0 +1,166 @@
+/* Mbed PID controllers on CMSIS-DSP kernels
+
+Copyright 2020 Jonathan L. Martin <jon.martini@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so, 
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+
+PID controllers turning a temperature error into heating or cooling power,
+in float, Q31 and Q15, on the arm_pid_f32/q31/q15 kernels from arm_math.h.
+
+The kernels are inline in arm_math.h, so they run without the CMSIS-DSP
+library, which isn't linked in this export.  Their init functions are in the
+library, so the gains are worked out here instead.  All three share one
+design so they can be swapped at build time and compared.
+
+*/
+
+#ifndef MBED_PID_H
+#define MBED_PID_H
+
+#include "mbed.h"
+#include "arm_math.h"
+#include "Temperature.h"
+
+/** Gains and scaling shared by the PID controllers
+ *
+ * The kernels run the velocity form, y[n] = y[n-1] + A0 e[n] + A1 e[n-1] +
+ * A2 e[n-2], with A0 = Kp + Ki T + Kd / T, A1 = -Kp - 2 Kd / T and
+ * A2 = Kd / T.  The fixed point ones need each A below 1, so full scale
+ * output is 100% << out_shift(), the smallest shift that fits the gains.
+ * Errors are clamped to the range given, which is a quarter of full scale
+ * input.  That keeps the Q31 kernel's accumulator, which wraps rather than
+ * saturates, clear of overflow.
+ *
+ * Power is limited to 0 .. kPowerFull by clamping y[n] and writing it back
+ * into the kernel's state, so the integral can't wind up past either end.
+ */
+class PidDesign {
+public:
+
+    // Full power from update(), hundredths of a percent
+    enum { kPowerFull = 10000 };
+
+    /** Design a controller
+     *
+     * @param kp - Proportional gain, % power per C
+     * @param ki - Integral gain, % power per C per second
+     * @param kd - Derivative gain, % power per C per second of change
+     * @param period_s - Time between update()s
+     * @param range_cC - Largest error the controller sees, more is clamped.
+     *                   100 / kp C is where the proportional term alone
+     *                   reaches full power.
+     */
+    PidDesign(float kp, float ki, float kd, float period_s, temp_cC range_cC);
+
+    /** Output full scale is 100% shifted up this far */
+    int out_shift(void) const {
+        return _out_shift;
+    }
+
+protected:
+    float   _a[3];       // A0, A1, A2 in % power per C
+    temp_cC _range_cC;
+    int     _out_shift;
+
+    temp_cC clamp(temp_cC error_cC) const {
+        return (error_cC > _range_cC) ? _range_cC : (error_cC < -_range_cC) ? -_range_cC : error_cC;
+    }
+};
+
+/** Floating point PID on arm_pid_f32, the reference the fixed point ones
+ *  are measured against.  Soft float on the Cortex-M3.
+ *
+ * Example:
+ * @code
+ * // 50%/C, 0.5%/C/s, 100%s/C at 1 Hz, errors clamped to 2 C
+ * PidF32 Cooler(50.0, 0.5, 100.0, 1.0, TEMP_CC(2.0));
+ * Cooler.reset(Shirt_cC - Set_cC, PidDesign::kPowerFull);
+ * while (true) {
+ *     int32_t power = Cooler.update(Shirt_cC - Set_cC);
+ *     TECs.setClimate(TEC::Cooling, power / 100.0);
+ *     wait(1.0);
+ * }
+ * @endcode
+ */
+class PidF32 : public PidDesign {
+public:
+
+    /** Create a controller, see PidDesign for the parameters */
+    PidF32(float kp, float ki, float kd, float period_s, temp_cC range_cC);
+
+    /** Start from a power without a kick, as if the error had held steady
+     *
+     * @param error_cC - Current error, positive wants more power
+     * @param power - Power to carry on from, 0 .. kPowerFull
+     */
+    void reset(temp_cC error_cC, int32_t power);
+
+    /** Run one period
+     *
+     * @param error_cC - How far from the set point, positive wants more power
+     * @returns power, 0 .. kPowerFull
+     */
+    int32_t update(temp_cC error_cC);
+
+protected:
+    arm_pid_instance_f32 _pid;
+};
+
+/** Q31 PID on arm_pid_q31, the same design as PidF32 in integers */
+class PidQ31 : public PidDesign {
+public:
+
+    /** Create a controller, see PidDesign for the parameters */
+    PidQ31(float kp, float ki, float kd, float period_s, temp_cC range_cC);
+
+    /** As PidF32::reset() */
+    void reset(temp_cC error_cC, int32_t power);
+
+    /** As PidF32::update() */
+    int32_t update(temp_cC error_cC);
+
+protected:
+    arm_pid_instance_q31 _pid;
+    int32_t _in_scale;   // error_cC to Q31, range_cC is 0.25
+    q31_t   _out_full;   // Q31 output at full power
+};
+
+/** Q15 PID on arm_pid_q15, the same design with 16 bit gains and state.
+ *  Coarser: small integral gains round towards zero, and the output has
+ *  only 2^(15 - out_shift()) steps to full power.
+ */
+class PidQ15 : public PidDesign {
+public:
+
+    /** Create a controller, see PidDesign for the parameters */
+    PidQ15(float kp, float ki, float kd, float period_s, temp_cC range_cC);
+
+    /** As PidF32::reset() */
+    void reset(temp_cC error_cC, int32_t power);
+
+    /** As PidF32::update() */
+    int32_t update(temp_cC error_cC);
+
+protected:
+    arm_pid_instance_q15 _pid;
+    int32_t _in_scale;   // error_cC to Q15 << 16, range_cC is 0.25
+    q15_t   _out_full;   // Q15 output at full power
+};
+
+#endif // MBED_PID_H
@@ -0,0 +1,151 @@
+/* mbed PWM quiet window sampling scheduler
+
+Copyright 2020 Jonathan L. Martin <jon.martini@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so, 
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+
+Use to take ADC samples away from the PWM switching edges.
+
+The edges are gathered from the match registers in use, sorted, and the
+widest gap between neighbours, wrapping through the end of the period, is the
+quiet window.  The counter's rate rarely changes, so the settle and sample
+times are only turned into counter ticks when it does.
+
+ */
+
+#include "PwmQuiet.h"
+#include "Pwm1Match.h"
+
+#include "mbed.h"
+
+PwmQuiet::PwmQuiet(float settle_us, float sample_us)
+{
+    _settle_us    = settle_us;
+    _sample_us    = sample_us;
+    _crowded      = 0;
+    _rate_hz      = 0;
+    _settle_ticks = 0;
+    _sample_ticks = 0;
+    _poll_ticks   = 1;
+}
+
+uint32_t PwmQuiet::counter_rate_hz(void)
+{
+    // PCLKSEL0 bits 13:12 divide the core clock for PWM1
+    static const uint32_t kDivider[4] = {4, 1, 2, 8};
+    const uint32_t pclk = SystemCoreClock / kDivider[(LPC_SC->PCLKSEL0 >> 12) & 3];
+    return pclk / (LPC_PWM1->PR + 1);
+}
+
+void PwmQuiet::wait(void)
+{
+    const uint32_t period = LPC_PWM1->MR0;
+    if (((LPC_PWM1->TCR & 1) == 0) || (period < 2))
+    {
+        return;    // PWM1 not running, nothing switches
+    }
+
+    const uint32_t rate_hz = counter_rate_hz();
+    if (rate_hz != _rate_hz)
+    {
+        _rate_hz      = rate_hz;
+        _settle_ticks = (uint32_t)(_settle_us * (rate_hz / 1.0e6f));
+        _sample_ticks = (uint32_t)(_sample_us * (rate_hz / 1.0e6f));
+        _poll_ticks   = rate_hz / 1000000 + 1;    // about a microsecond
+    }
+
+    // The period start, then both edges of every enabled channel.  A match
+    // at or past MR0 never fires, the output just stays where it is.
+    uint32_t edges[1 + 2 * 6];
+    int      count = 0;
+    edges[count++] = 0;
+    const uint32_t pcr = LPC_PWM1->PCR;
+    for (int ch = 1; ch <= 6; ch++)
+    {
+        if ((pcr & (1 << (ch + 8))) == 0)
+        {
+            continue;
+        }
+        const uint32_t reset = *pwm1_match_register(ch);
+        if ((reset > 0) && (reset < period))
+        {
+            edges[count++] = reset;
+        }
+        if ((ch > 1) && (pcr & (1 << ch)))
+        {
+            const uint32_t set = *pwm1_match_register(ch - 1);
+            if ((set > 0) && (set < period))
+            {
+                edges[count++] = set;
+            }
+        }
+    }
+    for (int i = 1; i < count; i++)
+    {
+        const uint32_t edge = edges[i];
+        int j = i;
+        for (; (j > 0) && (edges[j - 1] > edge); j--)
+        {
+            edges[j] = edges[j - 1];
+        }
+        edges[j] = edge;
+    }
+
+    uint32_t start = 0;
+    uint32_t gap   = 0;
+    for (int i = 0; i < count; i++)
+    {
+        const uint32_t next = (i + 1 < count) ? edges[i + 1] : edges[0] + period;
+        if (next - edges[i] > gap)
+        {
+            start = edges[i];
+            gap   = next - edges[i];
+        }
+    }
+
+    // Sample just past the settle time, or as far from both edges as the
+    // gap allows when it can't hold a whole sample
+    uint32_t window;
+    if (gap >= _settle_ticks + _sample_ticks + _poll_ticks)
+    {
+        start += _settle_ticks;
+        window = gap - _settle_ticks - _sample_ticks;
+    } else {
+        _crowded++;
+        start += (gap > _sample_ticks) ? (gap - _sample_ticks) / 2 : 0;
+        window = _poll_ticks;
+    }
+    start %= period;
+
+    uint32_t last  = LPC_PWM1->TC;
+    int      wraps = 0;
+    while (true)
+    {
+        const uint32_t tc = LPC_PWM1->TC;
+        if (((tc + period - start) % period) < window)
+        {
+            return;
+        }
+        if ((tc < last) && (++wraps >= 2))
+        {
+            return;    // never found it, don't hold the sensor thread up
+        }
+        last = tc;
+    }
+}
@@ -0,0 +1,111 @@
+/* mbed PWM quiet window sampling scheduler
+
+Copyright 2020 Jonathan L. Martin <jon.martini@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so, 
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+
+Use to take ADC samples away from the PWM switching edges, where the supply
+and ground bounce while the TEC H-bridges and the fans change over.
+
+LPC1768 only, the PWM1 match registers are read directly.  Only PWM1 edges
+are seen: outputs switched from interrupts, like DcPump's software PWM on
+GPIO pins, are not avoided.
+
+ */
+
+#ifndef MBED_PWM_QUIET_H
+#define MBED_PWM_QUIET_H
+
+#include "mbed.h"
+
+/** Wait for a quiet window between PWM edges before sampling
+ *
+ * Every PwmOut on the LPC1768 runs from PWM1 with one period, so every
+ * switching edge is a PWM1 match register: MR0 starts the period, MRn ends an
+ * enabled channel n and, in double edge mode as TecBank uses, MRn-1 starts it.
+ * wait() reads them each call, so it follows duty cycle changes, finds the
+ * widest gap between edges and spins until the PWM counter is just past the
+ * start of it.  When no gap is wide enough for a sample it still picks the
+ * widest, and counts a crowded() wait.
+ *
+ * Keep the time between wait() and the conversion short and steady, the
+ * counter keeps running.  With PWM1 stopped wait() returns at once.
+ *
+ * Software PWM, such as a DcPump on a GPIO pin, switches from ticker
+ * interrupts that can land anywhere in the window.  Those edges are rare, a
+ * DcPump switches twice per 10 ms, so few readings land near one, but they
+ * are not kept out.
+ *
+ * Example:
+ * @code
+ * #include "mbed.h"
+ * #include "PwmQuiet.h"
+ *
+ * PwmOut   Heater(p21);
+ * AnalogIn Sensor(p19);
+ * PwmQuiet Quiet(2.0, 20.0);  // settle after an edge, one read_u16()
+ *
+ * int main() {
+ *     Heater.period_us(100);
+ *     Heater = 0.3;
+ *     while(1) {
+ *         Quiet.wait();
+ *         uint16_t raw = Sensor.read_u16();
+ *         wait(0.1);
+ *     }
+ * }
+ * @endcode
+ */
+class PwmQuiet {
+public:
+
+    /** Create a scheduler
+     *
+     * @param settle_us - Time to leave after an edge for the ringing to die down
+     * @param sample_us - How long a sample takes from wait() returning, the
+     *                    gap must hold this after settle_us
+     */
+    PwmQuiet(float settle_us, float sample_us);
+
+    /** Spin until the PWM counter is at the start of the quiet window, at
+     *  most two PWM periods.
+     */
+    void wait(void);
+
+    /** Number of wait()s that found no gap wide enough and sampled in the
+     *  widest one anyway
+     */
+    uint32_t crowded(void) const {
+        return _crowded;
+    }
+
+protected:
+    float    _settle_us;
+    float    _sample_us;
+    uint32_t _crowded;
+    uint32_t _rate_hz;       // PWM1 counter rate the ticks below are for
+    uint32_t _settle_ticks;
+    uint32_t _sample_ticks;
+    uint32_t _poll_ticks;    // shortest window the spin loop can't miss
+
+    /* PWM1 counter rate, from the peripheral clock and prescaler */
+    uint32_t counter_rate_hz(void);
+};
+
+#endif // MBED_PWM_QUIET_H
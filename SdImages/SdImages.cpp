@@ -0,0 +1,97 @@
+/* Mbed images on the uLCD-144-G2 microSD card.
+
+Copyright 2020 Jonathan L. Martin <jon.martini@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so, 
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+
+The directory is read with read_word(), which steps through the card a word
+at a time, so start up needs no sector sized buffer on the display thread.
+
+*/
+
+#include "SdImages.h"
+
+#include "mbed.h"
+
+static const char kMagic[8] = {'P', 'C', 'C', 'U', 'I', '0', '0', '1'};
+
+SdImages::SdImages(uLCD_4DGL &lcd, uint32_t base_sector, uint32_t build_id, int count):
+    _lcd(lcd) {
+    _base_sector = base_sector;
+    _build_id    = build_id;
+    _count       = (count < kMaxImages) ? count : kMaxImages;
+    _ready       = false;
+}
+
+uint32_t SdImages::readLong(void)
+{
+    uint32_t value = (uint32_t)(_lcd.read_word() & 0xFFFF) << 16;
+    return value | (_lcd.read_word() & 0xFFFF);
+}
+
+bool SdImages::start(void)
+{
+    _ready = false;
+    if (_lcd.media_init() == 0)
+    {
+        return false;
+    }
+    const uint32_t address = _base_sector * SECTOR_SIZE;
+    _lcd.set_byte_address(address >> 16, address & 0xFFFF);
+
+    for (unsigned int i = 0; i < sizeof(kMagic); i += 2)
+    {
+        const int magic = _lcd.read_word() & 0xFFFF;
+        if (magic != (((uint8_t)kMagic[i] << 8) | (uint8_t)kMagic[i + 1]))
+        {
+            return false;
+        }
+    }
+    const int count = _lcd.read_word() & 0xFFFF;
+    _lcd.read_word(); // reserved
+    if ((count != _count) || (readLong() != _build_id))
+    {
+        return false;
+    }
+
+    for (int i = 0; i < _count; i++)
+    {
+        _offsets[i] = readLong();
+        readLong();   // width, height
+    }
+    _ready = true;
+    return true;
+}
+
+bool SdImages::ready(void)
+{
+    return _ready;
+}
+
+bool SdImages::draw(int image, int x, int y)
+{
+    if (!_ready || (image < 0) || (image >= _count))
+    {
+        return false;
+    }
+    const uint32_t sector = _base_sector + _offsets[image];
+    _lcd.set_sector_address(sector >> 16, sector & 0xFFFF);
+    _lcd.display_image(x, y);
+    return true;
+}
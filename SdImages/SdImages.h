@@ -0,0 +1,103 @@
+/* Mbed images on the uLCD-144-G2 microSD card.
+
+Copyright 2020 Jonathan L. Martin <jon.martini@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so, 
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+
+Draws pre-rendered images from the display's own card, so a label or glyph
+costs two short commands however many pixels it has.
+
+*/
+
+#ifndef MBED_SD_IMAGES_H
+#define MBED_SD_IMAGES_H
+
+#include "mbed.h"
+#include "uLCD_4DGL.h"
+
+/** Interface to images stored on the uLCD microSD card
+ *
+ * The card holds a directory sector followed by the images, each starting
+ * on a sector, as written by tools/ui_assets.py.  start() reads the directory
+ * and checks it was built with the same image list as the firmware, so an
+ * old or missing card just leaves ready() false and the caller can fall back
+ * to text.
+ *
+ * Example:
+ * @code
+ * // Draw image 0 from a card built by tools/ui_assets.py
+ * #include "mbed.h"
+ * #include "uLCD_4DGL.h"
+ * #include "SdImages.h"
+ * #include "ui_assets.h"
+ * 
+ * uLCD_4DGL uLCD(p13,p14,p15);
+ * 
+ * // lcd, directory sector, build id, number of images
+ * SdImages myImages(uLCD, kUiAssetSector, kUiAssetBuildId, kUiAssetCount);
+ * 
+ * int main() {
+ *     if (myImages.start()) {
+ *         myImages.draw(kUiLabels, 0, 8);
+ *     }
+ * }
+ * @endcode
+ */
+class SdImages {
+public:
+
+    enum { kMaxImages = 62 };
+
+    /** Create a set of card images
+     *
+     * @param lcd - The display with the card
+     * @param base_sector - Directory sector
+     * @param build_id - Build id the directory must have
+     * @param count - Number of images the directory must have
+     */
+    SdImages(uLCD_4DGL &lcd, uint32_t base_sector, uint32_t build_id, int count);
+
+    /** Start the card and read the directory
+     *
+     * @returns true if the card has the expected images
+     */
+    bool start(void);
+
+    /** Card started and images found */
+    bool ready(void);
+
+    /** Draw an image with its top left corner at x, y
+     *
+     * @param image - Image number, 0 to count - 1
+     * @returns false if not ready or image is out of range
+     */
+    bool draw(int image, int x, int y);
+
+protected:
+    uint32_t readLong(void);
+
+    uLCD_4DGL &_lcd;
+    uint32_t   _base_sector;
+    uint32_t   _build_id;
+    int        _count;
+    bool       _ready;
+    uint16_t   _offsets[kMaxImages]; // sectors from the directory
+};
+
+#endif
@@ -0,0 +1,265 @@
+/* Mbed data logger on the uLCD-144-G2 microSD card.
+
+Copyright 2020 Jonathan L. Martin <jon.martini@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so, 
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+
+Sequence numbers start at 1 so a blank card, all 0x00 or all 0xFF, never
+looks like a written sector.  A sector is finished as soon as it is written,
+even a partial one from sync(), so the log only ever appends.
+
+*/
+
+#include "SdLogger.h"
+
+#include "mbed.h"
+
+static const char kMagic[8] = {'P', 'C', 'C', 'L', 'O', 'G', '0', '1'};
+static const int  kVersion  = 1;
+static const char kSectorMarker = (char)0xA5;
+
+static void put16(char *p, uint32_t value)
+{
+    p[0] = value & 0xFF;
+    p[1] = (value >> 8) & 0xFF;
+}
+
+static void put32(char *p, uint32_t value)
+{
+    put16(p, value & 0xFFFF);
+    put16(p + 2, value >> 16);
+}
+
+static uint32_t get16(const char *p)
+{
+    return (uint8_t)p[0] | ((uint32_t)(uint8_t)p[1] << 8);
+}
+
+static uint32_t get32(const char *p)
+{
+    return get16(p) | (get16(p + 2) << 16);
+}
+
+SdLogger::SdLogger(uLCD_4DGL &lcd, uint32_t base_sector, uint32_t num_sectors, int record_size):
+    _lcd(lcd) {
+    _base_sector        = base_sector;
+    _num_sectors        = (num_sectors > 0) ? num_sectors : 1;
+    _record_size        = record_size;
+    _records_per_sector = (SECTOR_SIZE - kSectorHeaderSize) / record_size;
+    if (_records_per_sector > 255)
+    {
+        _records_per_sector = 255;
+    }
+    _fill            = 0;
+    _fill_records    = 0;
+    _pending         = -1;
+    _sync            = false;
+    _ready           = false;
+    _retry           = 0;
+    _sequence        = 1;
+    _boot_count      = 0;
+    _sectors_written = 0;
+    _dropped         = 0;
+}
+
+bool SdLogger::log(const void *record)
+{
+    bool logged = true;
+    _lock.lock();
+    if ((_fill_records >= _records_per_sector) && (_pending >= 0))
+    {
+        // Both buffers full, service() is behind
+        _dropped++;
+        logged = false;
+    } else
+    {
+        if (_fill_records >= _records_per_sector)
+        {
+            closeFill();
+        }
+        memcpy(&_buffers[_fill][kSectorHeaderSize + _fill_records * _record_size], record, _record_size);
+        _fill_records++;
+        if ((_fill_records >= _records_per_sector) && (_pending < 0))
+        {
+            closeFill();
+        }
+    }
+    _lock.unlock();
+    return logged;
+}
+
+// Hand the fill buffer to service(), called with _lock held and _pending free
+void SdLogger::closeFill(void)
+{
+    char *sector = _buffers[_fill];
+    sector[4] = 0; // sequence and boot count are filled in when written
+    sector[5] = 0;
+    sector[6] = _fill_records;
+    sector[7] = kSectorMarker;
+    memset(&sector[kSectorHeaderSize + _fill_records * _record_size], 0,
+           SECTOR_SIZE - kSectorHeaderSize - _fill_records * _record_size);
+    _pending      = _fill;
+    _fill         = 1 - _fill;
+    _fill_records = 0;
+}
+
+void SdLogger::sync(void)
+{
+    _lock.lock();
+    _sync = true;
+    _lock.unlock();
+}
+
+bool SdLogger::readSector(uint32_t sector, char *data)
+{
+    _lcd.set_sector_address(sector >> 16, sector & 0xFFFF);
+    return _lcd.read_sector(data) != 0;
+}
+
+bool SdLogger::writeSector(uint32_t sector, const char *data)
+{
+    _lcd.set_sector_address(sector >> 16, sector & 0xFFFF);
+    return _lcd.write_sector(data) != 0;
+}
+
+bool SdLogger::writeHeader(void)
+{
+    memset(_scratch, 0, sizeof(_scratch));
+    memcpy(_scratch, kMagic, sizeof(kMagic));
+    put16(&_scratch[8], kVersion);
+    put16(&_scratch[10], _record_size);
+    put32(&_scratch[12], _base_sector);
+    put32(&_scratch[16], _num_sectors);
+    put32(&_scratch[20], _sequence);
+    put32(&_scratch[24], _boot_count);
+    return writeSector(_base_sector, _scratch);
+}
+
+bool SdLogger::start(void)
+{
+    if (_lcd.media_init() == 0)
+    {
+        return false;
+    }
+
+    if (readSector(_base_sector, _scratch) &&
+        (memcmp(_scratch, kMagic, sizeof(kMagic)) == 0) &&
+        ((int)get16(&_scratch[10]) == _record_size) &&
+        (get32(&_scratch[16]) == _num_sectors))
+    {
+        _sequence   = get32(&_scratch[20]);
+        _boot_count = get32(&_scratch[24]) + 1;
+
+        // Skip the sectors written since the last checkpoint
+        for (int i = 0; i <= kCheckpointSectors; i++)
+        {
+            const uint32_t sector = _base_sector + 1 + (_sequence % _num_sectors);
+            if (!readSector(sector, _scratch) ||
+                (get32(_scratch) != _sequence) ||
+                (_scratch[7] != kSectorMarker))
+            {
+                break;
+            }
+            _sequence++;
+        }
+    } else
+    {
+        // No log yet, or one in a different layout, start a new one
+        _sequence   = 1;
+        _boot_count = 1;
+    }
+    return writeHeader();
+}
+
+void SdLogger::service(void)
+{
+    if (!_ready)
+    {
+        if (_retry > 0)
+        {
+            _retry--;
+            return;
+        }
+        _ready = start();
+        if (!_ready)
+        {
+            _retry = kRetryServices;
+            return;
+        }
+    }
+
+    _lock.lock();
+    // A sync waits while the previous sector is still pending
+    if (_sync && (_pending < 0))
+    {
+        if (_fill_records > 0)
+        {
+            closeFill();
+        }
+        _sync = false;
+    }
+    const int pending = _pending;
+    _lock.unlock();
+
+    if (pending < 0)
+    {
+        return;
+    }
+
+    // log() leaves the pending buffer alone until it is released below
+    char *sector = _buffers[pending];
+    put32(&sector[0], _sequence);
+    put16(&sector[4], _boot_count);
+    if (!writeSector(_base_sector + 1 + (_sequence % _num_sectors), sector))
+    {
+        // Card pulled or failed, keep the sector and start over
+        _ready = false;
+        _retry = kRetryServices;
+        return;
+    }
+    _sequence++;
+    _sectors_written++;
+    if ((_sequence % kCheckpointSectors) == 0)
+    {
+        writeHeader();
+    }
+
+    _lock.lock();
+    _pending = -1;
+    if (_fill_records >= _records_per_sector)
+    {
+        closeFill();
+    }
+    _lock.unlock();
+}
+
+bool SdLogger::ready(void)
+{
+    return _ready;
+}
+
+uint32_t SdLogger::sectors_written(void)
+{
+    return _sectors_written;
+}
+
+uint32_t SdLogger::dropped(void)
+{
+    return _dropped;
+}
@@ -0,0 +1,141 @@
+/* Mbed data logger on the uLCD-144-G2 microSD card.
+
+Copyright 2020 Jonathan L. Martin <jon.martini@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so, 
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+
+Appends fixed size records to a ring of raw sectors on the display's card,
+a whole sector per write, with a header sector so a host tool can find and
+order them.
+
+*/
+
+#ifndef MBED_SD_LOGGER_H
+#define MBED_SD_LOGGER_H
+
+#include "mbed.h"
+#include "rtos.h"
+#include "uLCD_4DGL.h"
+
+/** Interface to log records to the uLCD microSD card
+ *
+ * Records are packed into a RAM sector buffer by log(), which is cheap and
+ * safe from any thread.  service() does all the talking to the display, so
+ * call it from whichever thread owns the uLCD_4DGL.
+ *
+ * Card layout, all values little endian:
+ *  - base_sector: header, "PCCLOG01", version, record size, base sector,
+ *    number of data sectors, next sequence number, boot count
+ *  - base_sector + 1 + (sequence % num_sectors): data sector, sequence
+ *    number, boot count, record count, 0xA5, then the records
+ *
+ * The header is rewritten every kCheckpointSectors data sectors.  At start up
+ * the data sectors after the checkpoint are read to find the true end of the
+ * log, so at most the records still in RAM are lost on power off.
+ *
+ * Example:
+ * @code
+ * // Log a temperature every second
+ * #include "mbed.h"
+ * #include "uLCD_4DGL.h"
+ * #include "SdLogger.h"
+ * 
+ * uLCD_4DGL uLCD(p13,p14,p15);
+ * 
+ * // lcd, first sector, data sectors, record size
+ * SdLogger myLog(uLCD, 0x10000, 0x1000, sizeof(float));
+ * 
+ * int main() {
+ *     while(1) {
+ *         float temperature_C = 25.0;
+ *         myLog.log(&temperature_C);
+ *         myLog.service();
+ *         wait(1.0);
+ *     }
+ * }
+ * @endcode
+ */
+class SdLogger {
+public:
+
+    enum { kSectorHeaderSize = 8, kCheckpointSectors = 16 };
+
+    /** Create a logger
+     *
+     * @param lcd - The display with the card
+     * @param base_sector - Header sector, data follows it
+     * @param num_sectors - Data sectors in the ring
+     * @param record_size - Bytes per record, 2 to 504
+     */
+    SdLogger(uLCD_4DGL &lcd, uint32_t base_sector, uint32_t num_sectors, int record_size);
+
+    /** Add a record, any thread
+     *
+     * @param record - record_size bytes
+     * @returns false if the record was dropped because service() is behind
+     */
+    bool log(const void *record);
+
+    /** Write the records so far on the next service(), e.g. before power off */
+    void sync(void);
+
+    /** Start the card if needed and write any full sector, display thread only */
+    void service(void);
+
+    /** Card started and log found or created */
+    bool ready(void);
+
+    /** Data sectors written since start up */
+    uint32_t sectors_written(void);
+
+    /** Records dropped since start up */
+    uint32_t dropped(void);
+
+protected:
+    enum { kRetryServices = 60 };
+
+    bool start(void);
+    bool writeHeader(void);
+    bool readSector(uint32_t sector, char *data);
+    bool writeSector(uint32_t sector, const char *data);
+    void closeFill(void);
+
+    uLCD_4DGL &_lcd;
+    uint32_t   _base_sector;
+    uint32_t   _num_sectors;
+    int        _record_size;
+    int        _records_per_sector;
+
+    Mutex      _lock;
+    char       _buffers[2][SECTOR_SIZE];
+    char       _scratch[SECTOR_SIZE];
+    int        _fill;          // buffer log() appends to
+    int        _fill_records;
+    int        _pending;       // buffer waiting for service(), -1 for none
+    bool       _sync;
+
+    bool       _ready;
+    int        _retry;         // services until the next start attempt
+    uint32_t   _sequence;      // next data sector sequence number
+    uint32_t   _boot_count;
+    uint32_t   _sectors_written;
+    uint32_t   _dropped;
+};
+
+#endif
@@ -0,0 +1,54 @@
+/* mbed PWM1 match register lookup
+
+Copyright 2020 Jonathan L. Martin <jon.martini@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so, 
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+
+Shared by TecBank, which programs the PWM1 match registers, and PwmQuiet,
+which reads them to find the edges.
+
+LPC1768 only.
+
+ */
+
+#ifndef MBED_PWM1_MATCH_H
+#define MBED_PWM1_MATCH_H
+
+#include "mbed.h"
+
+/** Get PWM1 match register n, 0 to 6, or NULL
+ *
+ * MR4 - MR6 don't follow MR0 - MR3 in the register map.
+ */
+static inline volatile uint32_t *pwm1_match_register(int n)
+{
+    switch (n)
+    {
+        case 0: return &LPC_PWM1->MR0;
+        case 1: return &LPC_PWM1->MR1;
+        case 2: return &LPC_PWM1->MR2;
+        case 3: return &LPC_PWM1->MR3;
+        case 4: return &LPC_PWM1->MR4;
+        case 5: return &LPC_PWM1->MR5;
+        case 6: return &LPC_PWM1->MR6;
+    }
+    return NULL;
+}
+
+#endif // MBED_PWM1_MATCH_H
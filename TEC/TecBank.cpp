@@ -0,0 +1,219 @@
+/* mbed TEC bank controller
+
+Copyright 2020 Jonathan L. Martin <jon.martini@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so, 
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+
+Use to control four TECs connected to H-Bridges with staggered PWM
+
+In double edge mode PWM1 channel n is set by match register n-1 and reset by
+match register n.  Neighbouring channels share a register, so a channel's
+reset edge is the next channel's set edge and the on-windows chain naturally.
+A window that runs past MR0 wraps into the start of the next period.
+
+Direction pins are changed by clearing then setting bits through FIOCLR and
+FIOSET.  Neither is a read-modify-write, so ISRs driving other pins on the same
+port are safe, and between the two writes a changing TEC is briefly off rather
+than having both bridge inputs high.
+
+ */
+
+#include "TecBank.h"
+#include "Pwm1Match.h"
+
+#include "mbed.h"
+
+static int gpio_port(PinName pin)
+{
+    return (pin - P0_0) >> PORT_SHIFT;
+}
+
+static uint32_t gpio_bit(PinName pin)
+{
+    return 1 << ((pin - P0_0) & ((1 << PORT_SHIFT) - 1));
+}
+
+// PWM1.1 - PWM1.6 come out on P2.0 - P2.5 (p26 - p21 on the mbed)
+static int pwm_channel(PinName pin)
+{
+    if ((pin >= P2_0) && (pin <= P2_5))
+    {
+        return 1 + (pin - P2_0);
+    }
+    return 0;
+}
+
+TecBank::TecBank
+    (PinName ena_pin1, PinName cool_pin1, PinName heat_pin1,
+     PinName ena_pin2, PinName cool_pin2, PinName heat_pin2,
+     PinName ena_pin3, PinName cool_pin3, PinName heat_pin3,
+     PinName ena_pin4, PinName cool_pin4, PinName heat_pin4) {
+
+    PinName ena[kNumTecs]  = {ena_pin1,  ena_pin2,  ena_pin3,  ena_pin4};
+    PinName cool[kNumTecs] = {cool_pin1, cool_pin2, cool_pin3, cool_pin4};
+    PinName heat[kNumTecs] = {heat_pin1, heat_pin2, heat_pin3, heat_pin4};
+
+    // Order the TECs by channel so each window starts where the last one ended
+    for (int i = 0; i < kNumTecs; i++)
+    {
+        for (int j = i + 1; j < kNumTecs; j++)
+        {
+            if (pwm_channel(ena[j]) < pwm_channel(ena[i]))
+            {
+                PinName temp;
+                temp = ena[i];  ena[i]  = ena[j];  ena[j]  = temp;
+                temp = cool[i]; cool[i] = cool[j]; cool[j] = temp;
+                temp = heat[i]; heat[i] = heat[j]; heat[j] = temp;
+            }
+        }
+    }
+
+    _cool_mask = 0;
+    _heat_mask = 0;
+    _dir_bits  = 0;
+    for (int i = 0; i < kNumTecs; i++)
+    {
+        if ((gpio_port(cool[i]) != gpio_port(cool[0])) ||
+            (gpio_port(heat[i]) != gpio_port(cool[0])))
+        {
+            error("TecBank: cool and heat pins must share a GPIO port\n");
+        }
+        _cool_mask |= gpio_bit(cool[i]);
+        _heat_mask |= gpio_bit(heat[i]);
+    }
+    _dir_port = (LPC_GPIO_TypeDef *)(LPC_GPIO0_BASE + gpio_port(cool[0]) * (LPC_GPIO1_BASE - LPC_GPIO0_BASE));
+
+    for (int i = 0; i < kNumTecs; i++)
+    {
+        _channel[i] = pwm_channel(ena[i]);
+        if (_channel[i] < 2)
+        {
+            // PWM1.1 has no double edge mode
+            error("TecBank: enable pin must be on PWM1.2 - PWM1.6\n");
+        }
+        // Start with everything off
+        _cool_pin[i] = new DigitalOut(cool[i], 0);
+        _heat_pin[i] = new DigitalOut(heat[i], 0);
+        _ena_pin[i]  = new PwmOut(ena[i]);
+        *_ena_pin[i] = 0.0;
+    }
+
+    // Same 10 kHz as TEC, see TEC.cpp.  Shared by every PWM1 channel.
+    _ena_pin[0]->period(0.0001);
+
+    for (int i = 0; i < kNumTecs; i++)
+    {
+        // double edge select and output enable
+        LPC_PWM1->PCR |= (1 << _channel[i]) | (1 << (_channel[i] + 8));
+    }
+    for (int i = 0; i < 7; i++)
+    {
+        _match[i] = *pwm1_match_register(i);
+    }
+    _action        = TEC::Cooling;
+    _power_percent = -1.0; // force the first setClimate through
+    setWindows(0.0);
+}
+
+void TecBank::setDirection(uint32_t dir_bits)
+{
+    if (dir_bits == _dir_bits)
+    {
+        return;
+    }
+    _dir_port->FIOCLR = (_cool_mask | _heat_mask) & ~dir_bits;
+    _dir_port->FIOSET = dir_bits;
+    _dir_bits = dir_bits;
+}
+
+void TecBank::setWindows(float percent_power)
+{
+    const uint32_t period = LPC_PWM1->MR0;
+    if (period < 2)
+    {
+        return;
+    }
+    uint32_t window = (uint32_t)((percent_power / 100.0) * period + 0.5);
+    // Set and reset on the same count fight each other, stay just short of full on
+    if (window >= period)
+    {
+        window = period - 1;
+    }
+
+    uint32_t edge  = 0;
+    uint32_t latch = 0;
+    for (int i = 0; i < kNumTecs; i++)
+    {
+        // Shared with the previous channel's reset unless there is a gap
+        const int set_match = _channel[i] - 1;
+        if (((i == 0) || (set_match != _channel[i - 1])) && (_match[set_match] != edge))
+        {
+            *pwm1_match_register(set_match) = edge;
+            _match[set_match] = edge;
+            latch |= 1 << set_match;
+        }
+        edge = (edge + window) % period;
+        if (_match[_channel[i]] != edge)
+        {
+            *pwm1_match_register(_channel[i]) = edge;
+            _match[_channel[i]] = edge;
+            latch |= 1 << _channel[i];
+        }
+    }
+    // All new edges take effect together at the start of the next period
+    if (latch != 0)
+    {
+        LPC_PWM1->LER |= latch;
+    }
+}
+
+void TecBank::setClimate
+      (TEC::TecAction action,
+       float          power_percent)
+ {
+    if(power_percent < 0.0)
+    {
+        power_percent = 0.0;
+    }
+    if((action == _action) && (power_percent == _power_percent))
+    {
+        return; // nothing changed
+    }
+    _action        = action;
+    _power_percent = power_percent;
+
+    if(power_percent == 0.0)
+    {
+        // Remove all power
+        setDirection(0);
+        setWindows(0.0);
+    } else
+    {
+        switch (action)
+        {
+            case TEC::Heating:
+               setDirection(_heat_mask);
+               break;
+            case TEC::Cooling:
+               setDirection(_cool_mask);
+               break;
+        }
+        setWindows(power_percent);
+    }
+}
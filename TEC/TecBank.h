@@ -0,0 +1,116 @@
+/* mbed TEC bank controller
+
+Copyright 2020 Jonathan L. Martin <jon.martini@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so, 
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+
+Use to control four TECs connected to H-Bridges with staggered PWM so they
+don't all switch on together.
+
+LPC1768 only, the PWM1 match registers are programmed directly.
+
+ */
+
+#ifndef MBED_TEC_BANK_H
+#define MBED_TEC_BANK_H
+
+#include "mbed.h"
+#include "TEC.h"
+
+/** Interface to control four Thermo Electric Coolers as one bank.
+ *
+ * A plain PwmOut turns every channel on at the start of the period, so four
+ * TECs at the same power all switch on together and the supply sees the full
+ * current step every cycle.  TecBank runs the channels in double edge mode and
+ * chains their on-windows one after another around the period.  At 25% power
+ * or less only one TEC is ever on; above that the current stays almost flat.
+ *
+ * The enable pins must be on PWM1.2 - PWM1.6 (p21 - p25 on the mbed), and the
+ * match register just below the lowest channel must not be used by another
+ * PwmOut.  All channels are latched together at the start of the next period.
+ *
+ * The cool and heat pins must all be on one GPIO port so every H-bridge
+ * changes direction in one go.  Repeating the same setting writes nothing.
+ *
+ * Example:
+ * @code
+ * #include "mbed.h"
+ * #include "TecBank.h"
+ * 
+ * TecBank TECs(p21, p6,  p5,   // PWM Enable pin, cool pin, heat pin
+ *              p22, p8,  p7,
+ *              p23, p10, p9,
+ *              p24, p12, p11);
+ * 
+ * int main() {
+ *     TECs.setClimate(TEC::Cooling, 50.0);
+ *     while(1) {
+ *         wait(1.0);
+ *     }
+ * }
+ * @endcode
+ */
+class TecBank {
+public:
+
+    /** Number of TECs in the bank */
+    enum { kNumTecs = 4 };
+
+    /** Create a TEC bank
+     *
+     * Pins for each TEC are the same as for TEC: PWM enable, cool, heat.
+     */
+    TecBank(PinName ena_pin1, PinName cool_pin1, PinName heat_pin1,
+            PinName ena_pin2, PinName cool_pin2, PinName heat_pin2,
+            PinName ena_pin3, PinName cool_pin3, PinName heat_pin3,
+            PinName ena_pin4, PinName cool_pin4, PinName heat_pin4);
+
+    /** Set all TECs the same
+     *
+     * @param action Selects cooling or heating 
+     * @param percent_power  The amount of heating or cooling done.  
+     *                       Range 0.0 .. 100.0 as a percentage of full power
+     */
+    void setClimate
+      (TEC::TecAction action,
+       float          percent_power);
+
+protected:
+    PwmOut     *_ena_pin[kNumTecs];  // only used to claim the pins for PWM1
+    DigitalOut *_cool_pin[kNumTecs]; // only used to set up the pins,
+    DigitalOut *_heat_pin[kNumTecs]; // written together through _dir_port
+    int         _channel[kNumTecs];  // PWM1 channel, sorted so windows chain
+
+    LPC_GPIO_TypeDef *_dir_port;
+    uint32_t          _cool_mask;
+    uint32_t          _heat_mask;
+    uint32_t          _dir_bits;     // last direction written
+
+    uint32_t          _match[7];     // last value written to each PWM1 match register
+    TEC::TecAction    _action;
+    float             _power_percent;
+
+    /* sets the on-windows for every channel and latches them together */
+    void setWindows(float percent_power);
+
+    /* writes the cool/heat pins of every TEC at once */
+    void setDirection(uint32_t dir_bits);
+};
+
+#endif // MBED_TEC_BANK_H
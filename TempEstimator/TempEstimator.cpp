@@ -0,0 +1,99 @@
+/* Mbed temperature and slope estimator
+
+Copyright 2020 Jonathan L. Martin <jon.martini@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so, 
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+
+State x = [temperature, slope], one reading of the temperature per period.
+
+    temperature' = temperature + slope * period
+    slope'       = decay * slope + (1 - decay) * gain * input
+
+P is symmetric, so only three of its terms are kept.
+
+*/
+
+#include "TempEstimator.h"
+#include <math.h>
+
+// temp_from_C() without going through double
+static temp_cC cC_from_C(float celsius) {
+    return (temp_cC)(celsius * 100.0f + ((celsius < 0.0f) ? -0.5f : 0.5f));
+}
+
+TempEstimator::TempEstimator(float period_s, float gain_C_s, float response_s, float slope_noise_C_s, float noise_C) {
+    _period_s    = period_s;
+    _decay       = (response_s > 0.0f) ? expf(-period_s / response_s) : 0.0f;
+    _input_gain  = (1.0f - _decay) * gain_C_s;
+    _slope_noise = slope_noise_C_s * slope_noise_C_s;
+    // A little on the temperature too, so the filter never stops listening
+    _temp_noise  = 0.01f * noise_C * noise_C;
+    _noise       = noise_C * noise_C;
+    _started     = false;
+    reset(0);
+}
+
+void TempEstimator::reset(temp_cC t_cC) {
+    _temp_C = temp_to_C(t_cC);
+    _slope  = 0.0f;
+    _p00    = _noise;
+    _p01    = 0.0f;
+    // Don't know the slope yet, a degree a minute either way
+    _p11    = (1.0f / 60.0f) * (1.0f / 60.0f);
+}
+
+void TempEstimator::update(temp_cC measured_cC, float input) {
+    if (!_started) {
+        reset(measured_cC);
+        _started = true;
+        return;
+    }
+    const float dt = _period_s;
+    const float a  = _decay;
+
+    // Predict, x = F x + B u, P = F P F' + Q
+    _temp_C += _slope * dt;
+    _slope   = a * _slope + _input_gain * input;
+    const float p00 = _p00 + 2.0f * dt * _p01 + dt * dt * _p11 + _temp_noise;
+    const float p01 = a * (_p01 + dt * _p11);
+    const float p11 = a * a * _p11 + _slope_noise;
+
+    // Correct with the reading
+    const float residual = temp_to_C(measured_cC) - _temp_C;
+    const float s        = p00 + _noise;
+    const float k0       = p00 / s;
+    const float k1       = p01 / s;
+    _temp_C += k0 * residual;
+    _slope  += k1 * residual;
+    _p00 = (1.0f - k0) * p00;
+    _p01 = (1.0f - k0) * p01;
+    _p11 = p11 - k1 * p01;
+}
+
+temp_cC TempEstimator::temperature_cC(void) const {
+    return cC_from_C(_temp_C);
+}
+
+int32_t TempEstimator::slope_cC_min(void) const {
+    return cC_from_C(_slope * 60.0f);
+}
+
+temp_cC TempEstimator::predict_cC(float ahead_s) const {
+    return cC_from_C(_temp_C + _slope * ahead_s);
+}
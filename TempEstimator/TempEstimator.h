@@ -0,0 +1,121 @@
+/* Mbed temperature and slope estimator
+
+Copyright 2020 Jonathan L. Martin <jon.martini@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so, 
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+
+A two state Kalman filter, temperature and its rate of change, for a water
+loop driven by the TECs.  The TEC power is a known input: at full power the
+slope heads toward gain_C_s with a first order lag of response_s, everything
+the model misses (the body, the pump, ambient) is process noise on the
+slope.  Once a control period in single precision, a few hundred soft float
+cycles, so no fixed point here.
+
+*/
+
+#ifndef MBED_TEMP_ESTIMATOR_H
+#define MBED_TEMP_ESTIMATOR_H
+
+#include "mbed.h"
+#include "Temperature.h"
+
+/** Filtered temperature and dT/dt from one thermistor and the TEC power
+ *
+ * Example:
+ * @code
+ * // Shirt loop estimate, once a second
+ * #include "mbed.h"
+ * #include "Thermistor.h"
+ * #include "TempEstimator.h"
+ * 
+ * Thermistor shirt(p20, 3.3, 100000.0, 0.6172273387e-3, 2.287682172e-4, 0.6749479638e-7);
+ * 
+ * // period s, slope at full heating C/s, response s, slope noise C/s, sensor noise C
+ * TempEstimator estimate(1.0, 0.02, 20.0, 0.002, 0.05);
+ * 
+ * int main() {
+ *     float tec = 0.0;   // -1.0 full cooling to 1.0 full heating
+ *     while(1) {
+ *         estimate.update(shirt.temperature_cC(), tec);
+ *         // where the shirt will be in 20 s at the current slope
+ *         temp_cC ahead = estimate.predict_cC(20.0);
+ *         wait(1.0);
+ *     }
+ * }
+ * @endcode
+ */
+class TempEstimator {
+public:
+
+    /** Create an estimator, it starts from the first update
+     *
+     * @param period_s - Time between updates
+     * @param gain_C_s - Slope the loop settles to at full heating power, negative if heating the shirt cools this loop
+     * @param response_s - Time constant of the slope following the TEC power
+     * @param slope_noise_C_s - How far the slope may wander per period beyond the model, standard deviation
+     * @param noise_C - Measurement noise, standard deviation
+     */
+    TempEstimator(float period_s, float gain_C_s, float response_s, float slope_noise_C_s, float noise_C);
+
+    /** Start over from a temperature, slope 0
+     *
+     * @param t_cC - Temperature to start from
+     */
+    void reset(temp_cC t_cC);
+
+    /** Predict across the last period and correct with a new reading
+     *
+     * @param measured_cC - Temperature reading
+     * @param input - TEC power over the last period, -1.0 full cooling to 1.0 full heating
+     */
+    void update(temp_cC measured_cC, float input);
+
+    /** Get the filtered temperature */
+    temp_cC temperature_cC(void) const;
+
+    /** Get the rate of change in C per second */
+    float slope_C_s(void) const {
+        return _slope;
+    }
+
+    /** Get the rate of change in hundredths of a degree per minute, for telemetry */
+    int32_t slope_cC_min(void) const;
+
+    /** Get the temperature the current slope reaches after a while
+     *
+     * @param ahead_s - How far ahead, seconds
+     */
+    temp_cC predict_cC(float ahead_s) const;
+
+protected:
+    float _period_s;
+    float _decay;          // slope kept per period, exp(-period / response)
+    float _input_gain;     // slope added per period per unit of input
+    float _slope_noise;    // process noise variance on the slope
+    float _temp_noise;     // process noise variance on the temperature
+    float _noise;          // measurement noise variance
+    bool  _started;
+    float _temp_C;
+    float _slope;          // C per second
+    float _p00;            // covariance, temperature
+    float _p01;            // temperature and slope
+    float _p11;            // slope
+};
+
+#endif
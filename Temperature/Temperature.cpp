@@ -0,0 +1,88 @@
+/* Mbed fixed point temperatures
+
+Copyright 2020 Jonathan L. Martin <jon.martini@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so, 
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+
+*/
+
+#include "Temperature.h"
+#include "Formatter.h"
+
+temp_cC temp_from_C(double celsius)
+{
+    return (temp_cC)(celsius * 100.0 + ((celsius < 0) ? -0.5 : 0.5));
+}
+
+int temp_format(char *buffer, int size, temp_cC t, int width, int decimals)
+{
+    if (decimals > kTempDigits)
+    {
+        decimals = kTempDigits;
+    }
+    Formatter Text(buffer, size);
+    Text.fixed(t, kTempDigits, decimals, width);
+    return Text.length();
+}
+
+bool temp_parse(const char *text, temp_cC *t)
+{
+    const bool negative = (*text == '-');
+    if (negative)
+    {
+        text++;
+    }
+    int32_t value  = 0;
+    int     digits = 0;
+    int     places = -1;   // digits after the point, -1 before it
+    for (; *text != '\0'; text++)
+    {
+        if ((*text == '.') && (places < 0))
+        {
+            places = 0;
+        } else if ((*text >= '0') && (*text <= '9'))
+        {
+            if (places < kTempDigits)
+            {
+                if (value > 100000)
+                {
+                    return false;
+                }
+                value = value * 10 + (*text - '0');
+                if (places >= 0)
+                {
+                    places++;
+                }
+            }
+            digits++;
+        } else {
+            return false;
+        }
+    }
+    if (digits == 0)
+    {
+        return false;
+    }
+    for (int i = (places < 0) ? 0 : places; i < kTempDigits; i++)
+    {
+        value *= 10;
+    }
+    *t = negative ? -value : value;
+    return true;
+}
@@ -0,0 +1,100 @@
+/* Mbed fixed point temperatures
+
+Copyright 2020 Jonathan L. Martin <jon.martini@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so, 
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+
+Temperatures in hundredths of a degree C held in an int32_t.  The LPC1768 has
+no FPU, so every double compare, add and abs() in the control loop is a soft
+float library call; as temp_cC they are single integer instructions.
+
+*/
+
+#ifndef MBED_TEMPERATURE_H
+#define MBED_TEMPERATURE_H
+
+#include "mbed.h"
+
+/** Degrees C times 100, e.g. 2550 is 25.5 C
+ *
+ * Example:
+ * @code
+ * #include "mbed.h"
+ * #include "Temperature.h"
+ * 
+ * const temp_cC kMax_cC = TEMP_CC(40.0);
+ * 
+ * int main() {
+ *     char text[8];
+ *     temp_cC shirt_cC = temp_from_C(38.25);
+ *     if (temp_abs(shirt_cC - kMax_cC) <= TEMP_CC(2.0)) {
+ *         temp_format(text, sizeof(text), shirt_cC, 5, 1);  // " 38.3"
+ *         printf("%s C, nearly too hot\n", text);
+ *     }
+ * }
+ * @endcode
+ */
+typedef int32_t temp_cC;
+
+/** Decimal digits after the point held in a temp_cC, the scale to give
+ *  Formatter::fixed()
+ */
+enum { kTempDigits = 2 };
+
+/** A constant in degrees C as temp_cC, rounded and folded by the compiler */
+#define TEMP_CC(celsius) ((temp_cC)((celsius) * 100.0 + (((celsius) < 0) ? -0.5 : 0.5)))
+
+/** Magnitude of a temperature or temperature difference */
+inline temp_cC temp_abs(temp_cC t)
+{
+    return (t < 0) ? -t : t;
+}
+
+/** Degrees C as a float, for interfaces that still take one (fan curve, graph) */
+inline float temp_to_C(temp_cC t)
+{
+    return (float)t / 100;
+}
+
+/** Round degrees C to the nearest hundredth, a runtime TEMP_CC() */
+temp_cC temp_from_C(double celsius);
+
+/** Write a temperature as decimal text, right aligned like printf("%*.*f")
+ *  without touching floating point, see Formatter::fixed() to append one to
+ *  a longer line.  Rounds half away from zero and never prints "-0.0".
+ *
+ * @param buffer - Where to write, always NUL terminated when size > 0
+ * @param size - Size of buffer, output is truncated to fit
+ * @param t - The temperature
+ * @param width - Minimum characters, padded on the left with spaces
+ * @param decimals - Places after the point, 0 to 2
+ * @returns Characters written, not counting the NUL
+ */
+int temp_format(char *buffer, int size, temp_cC t, int width, int decimals);
+
+/** Read a temperature typed as decimal text, "25", "-3.5" or "37.25",
+ *  without touching floating point.  Digits past the hundredths are ignored.
+ *
+ * @param text - The text, nothing may follow the number
+ * @param t - Set to the temperature when the text is a number
+ * @returns true if the text was a number
+ */
+bool temp_parse(const char *text, temp_cC *t);
+
+#endif
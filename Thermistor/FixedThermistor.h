@@ -0,0 +1,148 @@
+/* Mbed Thermistor Sensor Interface, coefficients fixed at build time
+
+Copyright 2020 Jonathan L. Martin <jon.martini@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so, 
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+
+FixedThermistor<Params> reads like Thermistor's temperature_cC() but takes
+its table from Params, a table in flash generated by
+tools/thermistor_table.py, so there is no table in RAM, no log() or pow() at
+start up, and the table step is a compile time shift.  An instance is only
+its AnalogIn and the two limit readings.
+
+Use it for sensors that are never calibrated, a Thermistor is needed for
+calibrate().  Both read the same temperature for the same reading when
+built from the same coefficients.
+
+*/
+
+#ifndef MBED_FIXED_THERMISTOR_H
+#define MBED_FIXED_THERMISTOR_H
+
+#include "mbed.h"
+#include "Temperature.h"
+
+/** Thermistor with its table in flash
+ *
+ * Params provides the table:
+ *   enum { kTableShift = N };            read_u16() >> N indexes the table
+ *   static const temp_cC *table();       65536 >> N, plus 1, points
+ *
+ * Example:
+ * @code
+ * #include "mbed.h"
+ * #include "FixedThermistor.h"
+ * #include "thermistor_table.h"   // tools/thermistor_table.py --name Ntc3950
+ * 
+ * FixedThermistor<Ntc3950> myTempSensor(p20);
+ * 
+ * int main() {
+ *     char text[8];
+ *     while(1) {
+ *         temp_format(text, sizeof(text), myTempSensor.temperature_cC(), 5, 1);
+ *         printf("%s C\n", text);
+ *         wait(1.0);
+ *     }
+ * }
+ * @endcode
+ */
+template <class Params>
+class FixedThermistor {
+public:
+
+    enum { kStep = 1 << Params::kTableShift };
+
+    /** Create a thermistor sensor interface, wired as for Thermistor
+     *
+     * @param thermistor_pin - An AnalogIn pin with the thermistor connected
+     */
+    FixedThermistor(PinName thermistor_pin):
+        _thermistor_pin(thermistor_pin) {
+        _raw_hot  = 0;
+        _raw_cold = 65535;
+    }
+
+    /** Get the instant temperature in hundredths of a degree C */
+    temp_cC temperature_cC(void) {
+        return temperature_cC(_thermistor_pin.read_u16());
+    }
+
+    /** Get the temperature for a reading already taken with read_u16()
+     *
+     * @param raw - a read_u16() reading
+     */
+    static temp_cC temperature_cC(uint16_t raw) {
+        const temp_cC *table = Params::table();
+        const int i    = raw >> Params::kTableShift;
+        const int frac = raw & (kStep - 1);
+        // Same rounding as Thermistor, toward zero
+        return table[i] + ((table[i + 1] - table[i]) * frac) / kStep;
+    }
+
+    /** Take one ADC reading, 0 to 65535 */
+    uint16_t read_u16(void) {
+        return _thermistor_pin.read_u16();
+    }
+
+    /** Set the temperature range in_limits() accepts, see Thermistor::limits()
+     *
+     * @param min_cC - coldest allowed temperature
+     * @param max_cC - hottest allowed temperature
+     */
+    void limits(temp_cC min_cC, temp_cC max_cC) {
+        int32_t lo = 0;
+        int32_t hi = 65536;
+        while (lo < hi) {
+            const int32_t mid = (lo + hi) / 2;
+            if (temperature_cC((uint16_t)mid) <= max_cC) {
+                hi = mid;
+            } else {
+                lo = mid + 1;
+            }
+        }
+        _raw_hot = lo;
+
+        lo = -1;
+        hi = 65535;
+        while (lo < hi) {
+            const int32_t mid = (lo + hi + 1) / 2;
+            if (temperature_cC((uint16_t)mid) >= min_cC) {
+                lo = mid;
+            } else {
+                hi = mid - 1;
+            }
+        }
+        _raw_cold = lo;
+    }
+
+    /** Check a reading against limits() without converting it
+     *
+     * @param raw - a read_u16() reading
+     */
+    bool in_limits(uint16_t raw) const {
+        return (raw >= _raw_hot) && (raw <= _raw_cold);
+    }
+
+protected:
+    AnalogIn _thermistor_pin;
+    int32_t  _raw_hot;
+    int32_t  _raw_cold;
+};
+
+#endif
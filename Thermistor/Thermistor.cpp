@@ -23,8 +23,11 @@ SOFTWARE.
 */
 
 #include "Thermistor.h"
+#include "PwmQuiet.h"
 #include <math.h>
 
+const double Thermistor::kCalTolerance_C = 0.5;
+
 Thermistor::Thermistor(PinName thermistor_pin, double VCC, double R1, double A, double B, double C):
     _thermistor_pin(thermistor_pin) {
         _VCC = VCC;
@@ -32,6 +35,150 @@ Thermistor::Thermistor(PinName thermistor_pin, double VCC, double R1, double A,
         _A   = A;
         _B   = B;
         _C   = C;
+    _min_cC = kTableMin_cC;
+    _max_cC = kTableMax_cC;
+    _health     = kHealthOk;
+    _last_raw   = 0;
+    _same_count = 0;
+    _good_count = 0;
+    for (int h = 0; h < kHealthCount; h++) {
+        _faults[h] = 0;
+    }
+    _oversample_bits = 0;
+    _quiet           = NULL;
+    _dithered        = true;
+    _undithered      = 0;
+    build_table();
+}
+
+void Thermistor::build_table(void) {
+    // The divider is ratiometric, Vout / VCC = R / (R1 + R), so the table
+    // depends only on the ADC reading and R1.
+    const int step = 65536 / kTableSteps;
+    for (int i = 0; i < kTablePoints; i++) {
+        const double raw = i * step;
+        double t_C = (i == 0) ? kTableMax_cC / 100.0 : kTableMin_cC / 100.0;  // shorted or open
+        if ((raw > 0) && (raw < 65536.0)) {
+            const double ln_R2 = log(_R1 * raw / (65536.0 - raw));
+            t_C = (1.0 / (_A + (_B * ln_R2) + (_C * pow(ln_R2, 3.0)))) - 273.15;
+        }
+        temp_cC t_cC = temp_from_C(t_C);
+        if (t_cC > kTableMax_cC) {
+            t_cC = kTableMax_cC;
+        }
+        if (t_cC < kTableMin_cC) {
+            t_cC = kTableMin_cC;
+        }
+        _table[i] = t_cC;
+    }
+    limits(_min_cC, _max_cC);
+    _raw_open  = raw_at_or_above(kOpen_cC);
+    _raw_short = raw_at_or_below(kShort_cC);
+}
+
+void Thermistor::coefficients(double A, double B, double C) {
+    _A = A;
+    _B = B;
+    _C = C;
+    build_table();
+}
+
+void Thermistor::get_coefficients(double *A, double *B, double *C) {
+    *A = _A;
+    *B = _B;
+    *C = _C;
+}
+
+bool Thermistor::calibrate(const CalPoint *points, int count) {
+    // Three readings at least a few degrees apart, or there's no curve to fit
+    int distinct = 0;
+    for (int n = 0; n < count; n++) {
+        bool close = false;
+        for (int k = 0; k < n; k++) {
+            const int apart = points[n].raw - points[k].raw;
+            close = close || ((apart < 256) && (apart > -256));
+        }
+        distinct += close ? 0 : 1;
+    }
+    if (distinct < 3) {
+        return false;
+    }
+    // 1/T = A + B ln(R) + C ln(R)^3 is linear in A, B and C, so least
+    // squares is a 3 x 3 solve of the normal equations
+    double m[3][4] = {{0}};
+    for (int n = 0; n < count; n++) {
+        const double raw = points[n].raw;
+        if ((raw <= 0) || (raw >= 65536.0)) {
+            return false;
+        }
+        const double ln_R = log(_R1 * raw / (65536.0 - raw));
+        const double row[3] = {1.0, ln_R, ln_R * ln_R * ln_R};
+        const double inv_T = 1.0 / (temp_to_C(points[n].t_cC) + 273.15);
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) {
+                m[i][j] += row[i] * row[j];
+            }
+            m[i][3] += row[i] * inv_T;
+        }
+    }
+    // Gaussian elimination with partial pivoting
+    for (int col = 0; col < 3; col++) {
+        int pivot = col;
+        for (int r = col + 1; r < 3; r++) {
+            if (fabs(m[r][col]) > fabs(m[pivot][col])) {
+                pivot = r;
+            }
+        }
+        if (fabs(m[pivot][col]) < 1e-30) {
+            return false;   // two points at the same reading
+        }
+        for (int j = 0; j < 4; j++) {
+            const double swap = m[col][j];
+            m[col][j]   = m[pivot][j];
+            m[pivot][j] = swap;
+        }
+        for (int r = 0; r < 3; r++) {
+            if (r != col) {
+                const double f = m[r][col] / m[col][col];
+                for (int j = col; j < 4; j++) {
+                    m[r][j] -= f * m[col][j];
+                }
+            }
+        }
+    }
+    const double A = m[0][3] / m[0][0];
+    const double B = m[1][3] / m[1][1];
+    const double C = m[2][3] / m[2][2];
+
+    // Readings that disagree with each other, a typo or the reference not
+    // settled, leave the fit well off some of them
+    for (int n = 0; n < count; n++) {
+        const double raw  = points[n].raw;
+        const double ln_R = log(_R1 * raw / (65536.0 - raw));
+        const double t_C  = 1.0 / (A + (B * ln_R) + (C * ln_R * ln_R * ln_R)) - 273.15;
+        if (fabs(t_C - temp_to_C(points[n].t_cC)) > kCalTolerance_C) {
+            return false;
+        }
+    }
+
+    // An NTC gets colder as the reading rises, check the fit still does over
+    // the table's range before using it
+    double last_K = 1e9;
+    for (int i = 1; i < kTableSteps; i++) {
+        const double raw  = i * (65536.0 / kTableSteps);
+        const double ln_R = log(_R1 * raw / (65536.0 - raw));
+        const double inv_T = A + (B * ln_R) + (C * ln_R * ln_R * ln_R);
+        if (inv_T <= 0) {
+            return false;
+        }
+        const double t_K = 1.0 / inv_T;
+        if ((t_K - 273.15 > kTableMin_cC / 100.0) && (t_K - 273.15 < kTableMax_cC / 100.0) && (t_K >= last_K)) {
+            return false;
+        }
+        last_K = t_K;
+    }
+    coefficients(A, B, C);
+    return true;
 }
 
 double Thermistor::Vout(void) {
@@ -42,13 +189,25 @@ double Thermistor::Vout(void) {
     
 double Thermistor::R_thermistor(void) {
     const double Vout = Thermistor::Vout();
+    if (Vout >= _VCC) {
+        return HUGE_VAL;    // open, rather than dividing by zero
+    }
     return (Vout * _R1) / (_VCC - Vout);
 }
 
 double Thermistor::temperature_K(void) {
     // Implement the Steinhart-Hart equation to convert the measured 
     // voltage to temperature in Kelvin
-    const double ln_R2 = log (Thermistor::R_thermistor());
+    const double R = Thermistor::R_thermistor();
+    // Read an open or shorted sensor as the table's ends, not inf or NaN
+    // that every comparison lets through
+    if (!(R > 0.0)) {
+        return kTableMax_cC / 100.0 + 273.15;
+    }
+    if (R >= HUGE_VAL) {
+        return kTableMin_cC / 100.0 + 273.15;
+    }
+    const double ln_R2 = log (R);
     //     {      [     (          )   (        (          )) ] }
     return (1.0 / (_A + (_B * ln_R2) + (_C * pow(ln_R2, 3.0)) ) );
 }
@@ -57,6 +216,155 @@ double Thermistor::temperature_C(void) {
     return Thermistor::temperature_K() - 273.15;
 }
 
+temp_cC Thermistor::temperature_cC(void) {
+    return temperature_cC(_thermistor_pin.read_u16());
+}
+
+uint16_t Thermistor::read_u16(void) {
+    if ((_oversample_bits == 0) && (_quiet == NULL)) {
+        return _thermistor_pin.read_u16();
+    }
+    const int samples = 1 << (2 * _oversample_bits);
+    uint32_t sum  = 0;
+    uint16_t low  = 0xFFFF;
+    uint16_t high = 0;
+    for (int n = 0; n < samples; n++) {
+        if (_quiet != NULL) {
+            _quiet->wait();
+        }
+        const uint16_t code = _thermistor_pin.read_u16() >> 4;  // the ADC's 12 bits
+        sum += code;
+        low  = (code < low) ? code : low;
+        high = (code > high) ? code : high;
+    }
+    if (_oversample_bits > 0) {
+        _dithered = (high - low) >= kMinDitherCodes;
+        _undithered += _dithered ? 0 : 1;
+    }
+
+    // Average in read_u16() counts, rounded, then fill the bottom with the
+    // top bits as read_u16() does so full scale still reads 65535.  Without
+    // oversampling that is exactly read_u16().
+    const int shift = 2 * _oversample_bits;
+    const uint32_t average = ((sum << 4) + ((1 << shift) >> 1)) >> shift;
+    return (uint16_t)(average + (average >> 12));
+}
+
+void Thermistor::oversample(int bits, PwmQuiet *quiet) {
+    if (bits < 0) {
+        bits = 0;
+    }
+    if (bits > kMaxOversampleBits) {
+        bits = kMaxOversampleBits;
+    }
+    _oversample_bits = bits;
+    _quiet           = quiet;
+    _dithered        = true;
+}
+
+temp_cC Thermistor::temperature_cC(uint16_t raw) {
+    const int step = 65536 / kTableSteps;
+    const int i    = raw / step;
+    const int frac = raw % step;
+    // The table falls as the reading rises, so the difference is negative
+    return _table[i] + ((_table[i + 1] - _table[i]) * frac) / step;
+}
+
+void Thermistor::limits(temp_cC min_cC, temp_cC max_cC) {
+    _min_cC   = min_cC;
+    _max_cC   = max_cC;
+    _raw_hot  = raw_at_or_below(max_cC);
+    _raw_cold = raw_at_or_above(min_cC);
+}
+
+int32_t Thermistor::raw_at_or_below(temp_cC t_cC) {
+    // Binary search the same interpolation temperature_cC() does, so a
+    // reading is past the result exactly when its temperature is.  Left at
+    // 65536 when no reading is that cold.
+    int32_t lo = 0;
+    int32_t hi = 65536;
+    while (lo < hi) {
+        const int32_t mid = (lo + hi) / 2;
+        if (temperature_cC((uint16_t)mid) <= t_cC) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return lo;
+}
+
+int32_t Thermistor::raw_at_or_above(temp_cC t_cC) {
+    // As raw_at_or_below(), left at -1 when no reading is that hot
+    int32_t lo = -1;
+    int32_t hi = 65535;
+    while (lo < hi) {
+        const int32_t mid = (lo + hi + 1) / 2;
+        if (temperature_cC((uint16_t)mid) >= t_cC) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return lo;
+}
+
+Thermistor::Health Thermistor::check(uint16_t raw) {
+    // An ADC input that stopped converting, or a sensor potted so well it
+    // shows no noise at all, repeats the same code
+    if (raw == _last_raw) {
+        if (_same_count < kStuckSamples) {
+            _same_count++;
+        }
+    } else {
+        _last_raw   = raw;
+        _same_count = 0;
+    }
+
+    Health now = kHealthOk;
+    if (raw > _raw_open) {
+        now = kHealthOpen;
+    } else if (raw < _raw_short) {
+        now = kHealthShort;
+    } else if (_same_count >= kStuckSamples) {
+        now = kHealthStuck;
+    } else if (!in_limits(raw)) {
+        now = kHealthOutOfRange;
+    }
+
+    // Faults show at once and clear only after kClearSamples good readings
+    // in a row, so a loose connector counts once rather than every sample
+    if (now != kHealthOk) {
+        if (now != _health) {
+            _faults[now]++;
+        }
+        _health     = now;
+        _good_count = 0;
+    } else if ((_health != kHealthOk) && (++_good_count >= kClearSamples)) {
+        _health = kHealthOk;
+    }
+    return _health;
+}
+
+uint32_t Thermistor::fault_total(void) const {
+    uint32_t total = 0;
+    for (int h = kHealthOk + 1; h < kHealthCount; h++) {
+        total += _faults[h];
+    }
+    return total;
+}
+
+const char *Thermistor::health_name(Health health) {
+    switch (health) {
+        case kHealthOk:         return "ok";
+        case kHealthOpen:       return "open";
+        case kHealthShort:      return "short";
+        case kHealthStuck:      return "stuck";
+        case kHealthOutOfRange: return "range";
+        default:                return "?";
+    }
+}
+
 double Thermistor::temperature_F(void) {
     return ((9.0 / 5.0) * Thermistor::temperature_C()) + 32.0;
 }
\ No newline at end of file
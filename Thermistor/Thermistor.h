@@ -50,6 +50,25 @@ We generally use an R1 value close to the resistance at our expected nominal tem
 So in this case we choose a 100 KOhm resistor as a pull up.
 Our AnalogIn pin has a 0.0V to 3.3V range, so we pull up to 3.3V.
 
+temperature_cC() is the one to call in a control loop.  The Steinhart-Hart
+equation needs log() and pow() in double precision, which on an FPU-less
+LPC1768 is thousands of cycles of soft float per reading.  Instead the
+constructor evaluates it once at kTablePoints evenly spaced ADC readings and
+each reading interpolates between two of them in integer math.  With the
+100K NTC 3950 above the table is within 0.06 C of the equation from -5 C to
+95 C, well under the 1% part's own tolerance.
+
+The curve only falls as the ADC reading rises, so limits() turns a
+temperature range into a pair of read_u16() values once and in_limits()
+checks a reading against them with two integer compares.  Read the ADC once
+with read_u16() and pass the same reading to temperature_cC() and
+in_limits() so the value shown and the value checked always agree.
+
+Datasheet coefficients can be a degree or more off a real part at the ends
+of the range.  calibrate() fits A, B and C to readings taken against a
+reference thermometer, three points solve exactly, more are a least squares
+fit, and rebuilds the table, so reading a calibrated part costs the same.
+
 
 */
 
@@ -57,6 +76,9 @@ Our AnalogIn pin has a 0.0V to 3.3V range, so we pull up to 3.3V.
 #define MBED_THERMISTOR_H
 
 #include "mbed.h"
+#include "Temperature.h"
+
+class PwmQuiet;
 
 /** Interface to use a thermistor sensor.
  *
@@ -70,10 +92,10 @@ Our AnalogIn pin has a 0.0V to 3.3V range, so we pull up to 3.3V.
  * Thermistor myTempSensor(p20, 3.3, 100000.0, 0.6172273387e-3, 2.287682172e-4, 0.6749479638e-7);
  * 
  * int main() {
- *     float thisTemp_C;
+ *     char text[8];
  *     while(1) {
- *         thisTemp_C = myTempSensor.temperature_C();
- *         printf("printf("% 3.1f C", thisTemp_C);
+ *         temp_format(text, sizeof(text), myTempSensor.temperature_cC(), 5, 1);
+ *         printf("%s C\n", text);
  *         wait(1.0);
  *     }
  * }
@@ -82,6 +104,37 @@ Our AnalogIn pin has a 0.0V to 3.3V range, so we pull up to 3.3V.
 class Thermistor {
 public:
 
+    // Table points, one every 65536 / kTableSteps counts of read_u16(), and
+    // the range they are clamped to
+    enum { kTableSteps = 128, kTablePoints = kTableSteps + 1 };
+    enum { kTableMin_cC = -5500, kTableMax_cC = 15000 };
+
+    // Readings past these temperatures are a broken wire, not the loop
+    enum { kOpen_cC = -4000, kShort_cC = 12500 };
+    // Samples of one unchanging code before check() calls the sensor
+    // stuck, and good samples in a row before a fault clears
+    enum { kStuckSamples = 500, kClearSamples = 50 };
+
+    /** Sensor health, from check() */
+    enum Health {
+        kHealthOk,
+        kHealthOpen,        // reading colder than kOpen_cC, a broken wire
+        kHealthShort,       // hotter than kShort_cC, shorted
+        kHealthStuck,       // kStuckSamples of the same code, no noise at all
+        kHealthOutOfRange,  // a real reading outside limits()
+        kHealthCount
+    };
+
+    // Most extra bits oversample() gives, read_u16() has 16
+    enum { kMaxOversampleBits = 4 };
+    // Spread of ADC codes across a burst, largest less smallest, that shows
+    // noise for averaging to resolve between codes.  A burst that all reads
+    // one code gains nothing from the extra bits.
+    enum { kMinDitherCodes = 1 };
+
+    // Furthest calibrate() lets the fit stray from any of its points, C
+    static const double kCalTolerance_C;
+
     /** Create a thermistor sensor interface
      *  Wire up as a voltage divider like so:
      *  
@@ -132,6 +185,158 @@ public:
      */
     double temperature_F(void);
 
+    /** Get the instant temperature in hundredths of a degree C, without
+     *  floating point.  Readings beyond the table (an open or shorted
+     *  sensor) clamp to kTableMin_cC / kTableMax_cC.
+     */
+    temp_cC temperature_cC(void);
+
+    /** A reading taken against a reference thermometer */
+    struct CalPoint {
+        uint16_t raw;    // read_u16(), ideally filtered
+        temp_cC  t_cC;   // what the reference read
+    };
+
+    /** Fit the Steinhart-Hart coefficients to reference readings and
+     *  rebuild the table.  Spread the points over the range that matters,
+     *  the fit is only as good between them.  Leaves the coefficients alone
+     *  when the points don't make a thermistor curve.
+     *
+     * @param points - At least 3 readings, at different temperatures
+     * @param count - Number of points
+     * @returns true if the new coefficients are in use
+     */
+    bool calibrate(const CalPoint *points, int count);
+
+    /** Use new Steinhart-Hart coefficients, e.g. saved by an earlier calibrate()
+     *
+     * @param A - Steinhart-Hart coefficient A
+     * @param B - Steinhart-Hart coefficient B
+     * @param C - Steinhart-Hart coefficient C
+     */
+    void coefficients(double A, double B, double C);
+
+    /** Get the Steinhart-Hart coefficients in use
+     *
+     * @param A - Set to coefficient A
+     * @param B - Set to coefficient B
+     * @param C - Set to coefficient C
+     */
+    void get_coefficients(double *A, double *B, double *C);
+
+    /** Get the temperature for a reading already taken with read_u16()
+     *
+     * @param raw - a read_u16() reading
+     */
+    temp_cC temperature_cC(uint16_t raw);
+
+    /** Take one ADC reading, 0 to 65535.  With oversample() set this is a
+     *  burst of readings averaged down to 12 + bits bits.
+     *
+     */
+    uint16_t read_u16(void);
+
+    /** Oversample and decimate: read_u16() takes 4^bits ADC readings and
+     *  sums them, for bits more bits than the ADC's 12.  That only works with
+     *  a few tenths of a code of noise or more to dither between codes, see
+     *  dithered(), and costs 4^bits times the conversion time.
+     *  tools/adc_enob.py measures what each setting gains.
+     *
+     * @param bits - Extra bits, 0 to kMaxOversampleBits, 0 is single readings
+     * @param quiet - If given, each reading waits for a gap between PWM edges
+     *
+     * Example:
+     * @code
+     * PwmQuiet Quiet(2.0, 20.0);
+     * Radiator.oversample(2, &Quiet);  // 16 readings, 14 bits
+     * uint16_t raw = Radiator.read_u16();
+     * if (!Radiator.dithered()) {
+     *     // the readings all agreed, the extra bits are only rounding
+     * }
+     * @endcode
+     */
+    void oversample(int bits, PwmQuiet *quiet = NULL);
+
+    /** True when the last oversampled read_u16() spread over at least
+     *  kMinDitherCodes codes, so its extra bits carry information
+     */
+    bool dithered(void) const {
+        return _dithered;
+    }
+
+    /** Number of oversampled read_u16()s that weren't dithered() */
+    uint32_t undithered(void) const {
+        return _undithered;
+    }
+
+    /** Set the temperature range in_limits() accepts, both ends included.
+     *  Converted to ADC readings here, not per check.  Until called every
+     *  reading is in limits.
+     *
+     * @param min_cC - coldest allowed temperature
+     * @param max_cC - hottest allowed temperature
+     *
+     * Example:
+     * @code
+     * Radiator.limits(TEMP_CC(1.0), TEMP_CC(90.0));
+     * uint16_t raw = Radiator.read_u16();
+     * if (!Radiator.in_limits(raw)) {
+     *     // too hot, too cold, or the sensor is open or shorted
+     * }
+     * @endcode
+     */
+    void limits(temp_cC min_cC, temp_cC max_cC);
+
+    /** Check a reading against limits() without converting it
+     *
+     * @param raw - a read_u16() reading
+     * @returns true when temperature_cC(raw) is within the limits
+     */
+    bool in_limits(uint16_t raw) const {
+        return (raw >= _raw_hot) && (raw <= _raw_cold);
+    }
+
+    /** Classify a reading, call with every sample as it is taken.  Open,
+     *  short and out of range are judged on the raw code alone; stuck and
+     *  clearing a fault count samples, so call at a steady rate.
+     *
+     * @param raw - a read_u16() reading
+     * @returns the sensor's health after this reading
+     *
+     * Example:
+     * @code
+     * uint16_t raw = Radiator.read_u16();
+     * if (Radiator.check(raw) != Thermistor::kHealthOk) {
+     *     // stop heating and cooling, don't trust raw
+     * }
+     * @endcode
+     */
+    Health check(uint16_t raw);
+
+    /** The health the last check() found */
+    Health health(void) const {
+        return _health;
+    }
+
+    /** True when the sensor itself is broken: open, shorted or stuck */
+    bool sensor_fault(void) const {
+        return (_health == kHealthOpen) || (_health == kHealthShort) || (_health == kHealthStuck);
+    }
+
+    /** Times check() has gone into a fault
+     *
+     * @param health - which fault
+     */
+    uint32_t faults(Health health) const {
+        return _faults[health];
+    }
+
+    /** Times check() has gone into any fault */
+    uint32_t fault_total(void) const;
+
+    /** A short name for a health, e.g. "open" */
+    static const char *health_name(Health health);
+
 protected:
     AnalogIn _thermistor_pin;
     double _VCC;
@@ -139,7 +344,26 @@ protected:
     double _A;
     double _B;
     double _C;
-    float  _min_active_pwm;
+    temp_cC _table[kTablePoints];  // temperature at each table step of read_u16()
+    int32_t _raw_hot;   // lowest reading at or below the maximum temperature
+    int32_t _raw_cold;  // highest reading at or above the minimum temperature
+    temp_cC _min_cC;    // limits(), kept to redo them for new coefficients
+    temp_cC _max_cC;
+    int32_t _raw_open;   // readings above this are an open sensor
+    int32_t _raw_short;  // readings below this are a shorted one
+    Health _health;
+    uint16_t _last_raw;
+    int _same_count;     // samples the reading has not changed
+    int _good_count;     // good samples since the last fault
+    uint32_t _faults[kHealthCount];
+    int _oversample_bits;
+    PwmQuiet *_quiet;
+    bool _dithered;
+    uint32_t _undithered;
+
+    void build_table(void);
+    int32_t raw_at_or_below(temp_cC t_cC);
+    int32_t raw_at_or_above(temp_cC t_cC);
 };
 
 #endif
@@ -0,0 +1,127 @@
+/* Mbed scrolling trend graph for the uLCD-144-G2.
+
+Copyright 2020 Jonathan L. Martin <jon.martini@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so, 
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+
+Samples are kept as pixel rows, one byte per trace per column, so a redraw
+needs no scaling and the whole ring is at most 384 bytes.
+
+*/
+
+#include "TrendGraph.h"
+
+#include "mbed.h"
+
+TrendGraph::TrendGraph(uLCD_4DGL &lcd, int x, int y, int width, int height,
+                       float bottom, float top, int background):
+    _lcd(lcd) {
+    _x          = x;
+    _y          = y;
+    _width      = (width > kMaxWidth) ? kMaxWidth : width;
+    _height     = (height > kNoSample) ? kNoSample : height;
+    _bottom     = bottom;
+    _top        = (top != bottom) ? top : bottom + 1.0;
+    _background = background;
+    _num_traces = 0;
+    _column     = 0;
+    memset(_pending, kNoSample, sizeof(_pending));
+    memset(_rows, kNoSample, sizeof(_rows));
+}
+
+int TrendGraph::add_trace(int color)
+{
+    if (_num_traces >= kMaxTraces)
+    {
+        return -1;
+    }
+    _colors[_num_traces] = color;
+    return _num_traces++;
+}
+
+void TrendGraph::sample(int trace, float value)
+{
+    if ((trace < 0) || (trace >= _num_traces))
+    {
+        return;
+    }
+    int row = (int)((_top - value) * (_height - 1) / (_top - _bottom) + 0.5);
+    if (row < 0)
+    {
+        row = 0;
+    } else if (row > _height - 1)
+    {
+        row = _height - 1;
+    }
+    _pending[trace] = row;
+}
+
+void TrendGraph::drawColumn(int column)
+{
+    // Connect to the previous column unless this is the left edge or just
+    // after the blank column
+    const int previous = column - 1;
+    for (int t = 0; t < _num_traces; t++)
+    {
+        const int row = _rows[t][column];
+        if (row == kNoSample)
+        {
+            continue;
+        }
+        int from_column = column;
+        int from_row    = row;
+        if ((previous >= 0) && (previous != _column) && (_rows[t][previous] != kNoSample))
+        {
+            from_column = previous;
+            from_row    = _rows[t][previous];
+        }
+        _lcd.line(_x + from_column, _y + from_row, _x + column, _y + row, _colors[t]);
+    }
+}
+
+void TrendGraph::update(void)
+{
+    for (int t = 0; t < _num_traces; t++)
+    {
+        _rows[t][_column] = _pending[t];
+        _pending[t] = kNoSample;
+    }
+    drawColumn(_column);
+
+    _column++;
+    if (_column >= _width)
+    {
+        _column = 0;
+    }
+
+    // The next column holds the oldest samples, blank it
+    _lcd.line(_x + _column, _y, _x + _column, _y + _height - 1, _background);
+}
+
+void TrendGraph::redraw(void)
+{
+    _lcd.filled_rectangle(_x, _y, _x + _width - 1, _y + _height - 1, _background);
+    for (int column = 0; column < _width; column++)
+    {
+        if (column != _column)
+        {
+            drawColumn(column);
+        }
+    }
+}
@@ -0,0 +1,126 @@
+/* Mbed scrolling trend graph for the uLCD-144-G2.
+
+Copyright 2020 Jonathan L. Martin <jon.martini@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+the Software, and to permit persons to whom the Software is furnished to do so, 
+subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+
+Strip chart of a few values over time, drawn a column at a time so each
+sample costs a handful of line commands instead of a full redraw.
+
+*/
+
+#ifndef MBED_TREND_GRAPH_H
+#define MBED_TREND_GRAPH_H
+
+#include "mbed.h"
+#include "uLCD_4DGL.h"
+
+/** Interface to a strip chart on a uLCD_4DGL
+ *
+ * The graph sweeps left to right like a heart monitor.  Each sample draws
+ * the newest column and blanks the column after it, which holds the oldest
+ * sample, with one vertical line.  The blank column marks "now".
+ *
+ * Example:
+ * @code
+ * // Plot two temperatures along the bottom of the screen
+ * #include "mbed.h"
+ * #include "uLCD_4DGL.h"
+ * #include "TrendGraph.h"
+ * 
+ * uLCD_4DGL uLCD(p13,p14,p15);
+ * 
+ * // lcd, x, y, width, height, bottom value, top value
+ * TrendGraph myGraph(uLCD, 0, 80, 128, 48, 10.0, 40.0);
+ * 
+ * int main() {
+ *     int shirt = myGraph.add_trace(GREEN);
+ *     int user  = myGraph.add_trace(DGREY);
+ *     myGraph.redraw();
+ *     while(1) {
+ *         myGraph.sample(shirt, shirt_C);
+ *         myGraph.sample(user, user_C);
+ *         myGraph.update();
+ *         wait(1.0);
+ *     }
+ * }
+ * @endcode
+ */
+class TrendGraph {
+public:
+
+    enum { kMaxTraces = 3, kMaxWidth = 128 };
+
+    /** Create a trend graph
+     *
+     * @param lcd - The display to draw on
+     * @param x - Left edge in pixels
+     * @param y - Top edge in pixels
+     * @param width - Width in pixels, one sample per column, up to kMaxWidth
+     * @param height - Height in pixels, up to 255
+     * @param bottom - Value plotted on the bottom row
+     * @param top - Value plotted on the top row
+     * @param background - Background color, 0xRRGGBB
+     */
+    TrendGraph(uLCD_4DGL &lcd, int x, int y, int width, int height,
+               float bottom, float top, int background = BLACK);
+
+    /** Add a trace
+     *
+     * @param color - Trace color, 0xRRGGBB
+     * @returns The trace number to pass to sample(), or -1 if there are already kMaxTraces
+     */
+    int add_trace(int color);
+
+    /** Set the value a trace plots on the next update()
+     *
+     * Traces not sampled since the last update() leave a gap.
+     *
+     * @param trace - Trace number from add_trace()
+     * @param value - Value to plot, clamped to the graph
+     */
+    void sample(int trace, float value);
+
+    /** Draw the newest column and blank the oldest one */
+    void update(void);
+
+    /** Redraw the whole graph from the sample ring, e.g. after a cls() */
+    void redraw(void);
+
+protected:
+    enum { kNoSample = 0xFF };
+
+    void drawColumn(int column);
+
+    uLCD_4DGL &_lcd;
+    int        _x;
+    int        _y;
+    int        _width;
+    int        _height;
+    float      _bottom;
+    float      _top;
+    int        _background;
+    int        _num_traces;
+    int        _colors[kMaxTraces];
+    uint8_t    _pending[kMaxTraces];
+    uint8_t    _rows[kMaxTraces][kMaxWidth]; // sample ring, pixel row from the top
+    int        _column;                      // column the next update() draws
+};
+
+#endif
@@ -1,39 +1,54 @@
-// Buzz color array, 31 x 32 pixels
-// white boarder all around on white background means no need to clear anything as we move around the screen.
-// 0         1         2         3         4         5         6         7         8         9         10        11        12        13        14        15        16        17        18        19        20        21        22        23        24        25         26        27       28       29       30
-const int buzz[] = 
- {0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF,
-  0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF,
-  0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF,
-  0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF,
-  0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF,
-  0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xF5F5F5, 0x7D7A7B, 0x696566, 0xDADADA, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF,
-  0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xE9E9E9, 0x7E7C7D, 0x807E7E, 0xC9C8C8, 0xFFFFFF, 0xFFFFFF, 0xA5A4A4, 0x8B8889, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xCECDCD, 0xC1BFC0, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF,
-  0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xCDCCCC, 0x999797, 0xBBBABA, 0xFFFFFF, 0xFFFFFF, 0xA8A6A6, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xD0CFD0, 0xDCDCDC, 0xBFBEBE, 0xFFFFFF, 0xFFFFFF, 0xBDBCBC, 0xB0AFAF, 0xE1E0E0, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF,
-  0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xCDCCCD, 0x6A6869, 0xE0E0E0, 0xAEACAC, 0x767374, 0xEAEBED, 0xFFFFFF, 0xFFFFFF, 0xC2C1C1, 0xFFFFFF, 0xC8C7C8, 0xBFBEBF, 0xC7C6C6, 0xFFFFFF, 0xFFFFFF, 0xAFADAE, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF,
-  0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0x4B4849, 0x000006, 0x171314, 0x030000, 0x898687, 0x5A585B, 0x460900, 0xC18902, 0x929194, 0xFFFFFF, 0xDBDADB, 0x8E8C8C, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xAEADAD, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF,
-  0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xB6B5B6, 0x000009, 0xAF7E0C, 0x2F271E, 0x201D20, 0x181415, 0x181519, 0x2A241E, 0xFFBE00, 0xBF7F00, 0xFFFFFF, 0xA7A5A6, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xA6A4A4, 0xAEACAD, 0xEDEDED, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF,
-  0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0x818699, 0x9E6E00, 0xFFC500, 0x0E1122, 0x1B1921, 0x1E1B20, 0x090D23, 0x996800, 0xBDA264, 0xFEAD00, 0x7D766A, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xD0CFCF, 0xF4F4F4, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF,
-  0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0x765B1F, 0xF8AE00, 0xF6AE02, 0xC18A09, 0x362C1D, 0x342A1C, 0x895D00, 0xCBBFA5, 0xAB9971, 0xFFB200, 0xCCCDD2, 0xC99F3C, 0xA16C00, 0xB5B9C5, 0xCDCFD6, 0xC0C1C5, 0xE5E5E5, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF,
-  0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xB8B5B1, 0xCB8A00, 0xF3AC03, 0xEEA904, 0xF5AD03, 0xFFB900, 0xF4AA00, 0x898CAA, 0xCBA751, 0xFFB700, 0x564117, 0xAC7C0C, 0xFFB100, 0x93866B, 0xFFFFFF, 0xB69957, 0xD6CDB8, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF,
-  0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0x9B7F42, 0xE9A300, 0xEFA903, 0xEEA904, 0xF3AC03, 0xDB9B04, 0x957327, 0xEBA400, 0xFFBA00, 0x32291E, 0x634B16, 0xFFC400, 0xE39D00, 0xA1A1A5, 0xAFB4C4, 0xC58300, 0xF3A000, 0xC9C1AF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF,
-  0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0x825F10, 0xF9AF00, 0xEEA903, 0xF7AF02, 0xD19507, 0xD49707, 0xFFBA00, 0xFFB600, 0x362C1D, 0x161621, 0x1B1921, 0x896411, 0x1E1712, 0xE8CB84, 0xFFFFFF, 0xAD8938, 0xCA8100, 0xC8CDDC, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF,
-  0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0x8E7133, 0xFBAB00, 0xF7AA00, 0xAA7702, 0xD99904, 0xCC9002, 0x7F5B0B, 0x14131C, 0x19171F, 0x231F20, 0x211E20, 0x0E1022, 0x40331B, 0xCD8900, 0x848899, 0xFFFFFF, 0xB8AD97, 0xE9EAEE, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF,
-  0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xE6EAF4, 0xC2A051, 0xC0B9AA, 0x898378, 0xC39317, 0x7F6C3D, 0x393C4E, 0x393639, 0x171314, 0x131219, 0x080D23, 0x211D20, 0xEAA604, 0xA9790A, 0x080815, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF,
-  0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0x97979C, 0xB08B30, 0xBF8200, 0x958F88, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0x8D743C, 0xFFBB00, 0xFFCC00, 0xD19508, 0x13131E, 0x1D1B23, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF,
-  0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xBFC1C8, 0xBAA984, 0xFFB000, 0xA08E67, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0x2B241D, 0x17161E, 0x29231F, 0x0B0E23, 0x0B0D20, 0x624A17, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF,
-  0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xCED1DA, 0x6B4100, 0xA7873D, 0xECEDF0, 0xFFFFFF, 0xFFFFFF, 0x575B6A, 0xDC9800, 0x3A2E1C, 0x080D23, 0x1A1921, 0x9E720D, 0x795300, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF,
-  0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0x3F414D, 0xA47405, 0xFFC600, 0xFFC000, 0xFFC400, 0xF3AB00, 0x1B1D2D, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF,
-  0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0x8E8C8E, 0x000016, 0x7D5C13, 0xB07F0C, 0x815E12, 0x000008, 0x929193, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF,
-  0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xE9ECF5, 0x644500, 0x010418, 0x00000E, 0x000001, 0x6A686A, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF,
-  0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xB7A069, 0xFFAB00, 0xB69E63, 0xC7C9D0, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF,
-  0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xD0CECB, 0xA86E00, 0xCAC6BC, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF,
-  0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xB4AC97, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF,
-  0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF,
-  0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF,
-  0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF,
-  0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF,
-  0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF};
+// buzz, 31 x 32 pixels, RGB565 run length encoded
+// Generated by tools/rgb565_asset.py from buzz.h, 1072 bytes of flash.
+// Draw with uLCD.BLIT_RLE(x, y, buzz_w, buzz_h, buzz);
+#include <stdint.h>
+
+const uint16_t buzz[] =
+ {0x00A3, 0xFFFF, 0x0001, 0xF7BE, 0x0001, 0x7BCF, 0x0001, 0x6B2C, 0x0001, 0xDEDB, 0x0018, 0xFFFF,
+ 0x0001, 0xEF5D, 0x0001, 0x7BEF, 0x0001, 0x83EF, 0x0001, 0xCE59, 0x0002, 0xFFFF, 0x0001, 0xA534,
+ 0x0001, 0x8C51, 0x0006, 0xFFFF, 0x0001, 0xCE79, 0x0001, 0xC5F8, 0x0012, 0xFFFF, 0x0001, 0xCE79,
+ 0x0001, 0x9CB2, 0x0001, 0xBDD7, 0x0002, 0xFFFF, 0x0001, 0xAD34, 0x0004, 0xFFFF, 0x0001, 0xD67A,
+ 0x0001, 0xDEFB, 0x0001, 0xBDF7, 0x0002, 0xFFFF, 0x0001, 0xBDF7, 0x0001, 0xB575, 0x0001, 0xE71C,
+ 0x000F, 0xFFFF, 0x0001, 0xCE79, 0x0001, 0x6B4D, 0x0001, 0xE71C, 0x0001, 0xAD75, 0x0001, 0x738E,
+ 0x0001, 0xEF5D, 0x0002, 0xFFFF, 0x0001, 0xC618, 0x0001, 0xFFFF, 0x0001, 0xCE39, 0x0001, 0xBDF7,
+ 0x0001, 0xC638, 0x0002, 0xFFFF, 0x0001, 0xAD75, 0x000E, 0xFFFF, 0x0001, 0x4A49, 0x0001, 0x0000,
+ 0x0001, 0x1082, 0x0001, 0x0000, 0x0001, 0x8C30, 0x0001, 0x5ACB, 0x0001, 0x4040, 0x0001, 0xC440,
+ 0x0001, 0x9492, 0x0001, 0xFFFF, 0x0001, 0xDEDB, 0x0001, 0x8C71, 0x0003, 0xFFFF, 0x0001, 0xAD75,
+ 0x000E, 0xFFFF, 0x0001, 0xB5B6, 0x0001, 0x0001, 0x0001, 0xABE1, 0x0001, 0x2923, 0x0001, 0x20E4,
+ 0x0001, 0x18A2, 0x0001, 0x18A3, 0x0001, 0x2923, 0x0001, 0xFDE0, 0x0001, 0xBBE0, 0x0001, 0xFFFF,
+ 0x0001, 0xA534, 0x0003, 0xFFFF, 0x0001, 0xA534, 0x0001, 0xAD75, 0x0001, 0xEF7D, 0x000D, 0xFFFF,
+ 0x0001, 0x8433, 0x0001, 0x9B60, 0x0001, 0xFE20, 0x0001, 0x0884, 0x0002, 0x18C4, 0x0001, 0x0864,
+ 0x0001, 0x9B40, 0x0001, 0xBD0C, 0x0001, 0xFD60, 0x0001, 0x7BAD, 0x0005, 0xFFFF, 0x0001, 0xD679,
+ 0x0001, 0xF7BE, 0x000D, 0xFFFF, 0x0001, 0x72C3, 0x0001, 0xFD60, 0x0001, 0xF560, 0x0001, 0xC441,
+ 0x0001, 0x3163, 0x0001, 0x3143, 0x0001, 0x8AE0, 0x0001, 0xCDF4, 0x0001, 0xACCE, 0x0001, 0xFD80,
+ 0x0001, 0xCE7A, 0x0001, 0xCCE7, 0x0001, 0xA360, 0x0001, 0xB5D8, 0x0001, 0xCE7A, 0x0001, 0xC618,
+ 0x0001, 0xE73C, 0x000D, 0xFFFF, 0x0001, 0xBDB6, 0x0001, 0xCC40, 0x0001, 0xF560, 0x0001, 0xED40,
+ 0x0001, 0xF560, 0x0001, 0xFDC0, 0x0001, 0xF540, 0x0001, 0x8C75, 0x0001, 0xCD2A, 0x0001, 0xFDA0,
+ 0x0001, 0x5202, 0x0001, 0xABE1, 0x0001, 0xFD80, 0x0001, 0x942D, 0x0001, 0xFFFF, 0x0001, 0xB4CA,
+ 0x0001, 0xD677, 0x000E, 0xFFFF, 0x0001, 0x9BE8, 0x0001, 0xED00, 0x0002, 0xED40, 0x0001, 0xF560,
+ 0x0001, 0xDCC0, 0x0001, 0x9384, 0x0001, 0xED20, 0x0001, 0xFDC0, 0x0001, 0x3143, 0x0001, 0x6242,
+ 0x0001, 0xFE20, 0x0001, 0xE4E0, 0x0001, 0xA514, 0x0001, 0xADB8, 0x0001, 0xC400, 0x0001, 0xF500,
+ 0x0001, 0xCE15, 0x000D, 0xFFFF, 0x0001, 0x82E2, 0x0001, 0xFD60, 0x0001, 0xED40, 0x0001, 0xF560,
+ 0x0002, 0xD4A0, 0x0001, 0xFDC0, 0x0001, 0xFDA0, 0x0001, 0x3163, 0x0001, 0x10A4, 0x0001, 0x18C4,
+ 0x0001, 0x8B22, 0x0001, 0x18A2, 0x0001, 0xEE50, 0x0001, 0xFFFF, 0x0001, 0xAC47, 0x0001, 0xCC00,
+ 0x0001, 0xCE7B, 0x000D, 0xFFFF, 0x0001, 0x8B86, 0x0001, 0xFD40, 0x0001, 0xF540, 0x0001, 0xABA0,
+ 0x0001, 0xDCC0, 0x0001, 0xCC80, 0x0001, 0x7AC1, 0x0001, 0x1083, 0x0001, 0x18A3, 0x0002, 0x20E4,
+ 0x0001, 0x0884, 0x0001, 0x4183, 0x0001, 0xCC40, 0x0001, 0x8453, 0x0001, 0xFFFF, 0x0001, 0xBD72,
+ 0x0001, 0xEF5D, 0x000D, 0xFFFF, 0x0001, 0xE75E, 0x0001, 0xC50A, 0x0001, 0xC5D5, 0x0001, 0x8C0F,
+ 0x0001, 0xC482, 0x0001, 0x7B67, 0x0001, 0x39E9, 0x0001, 0x39A7, 0x0001, 0x1082, 0x0001, 0x1083,
+ 0x0001, 0x0864, 0x0001, 0x20E4, 0x0001, 0xED20, 0x0001, 0xABC1, 0x0001, 0x0842, 0x0012, 0xFFFF,
+ 0x0001, 0x94B3, 0x0001, 0xB446, 0x0001, 0xBC00, 0x0001, 0x9471, 0x0003, 0xFFFF, 0x0001, 0x8BA7,
+ 0x0001, 0xFDC0, 0x0001, 0xFE60, 0x0001, 0xD4A1, 0x0001, 0x1083, 0x0001, 0x18C4, 0x0012, 0xFFFF,
+ 0x0001, 0xBE19, 0x0001, 0xBD50, 0x0001, 0xFD80, 0x0001, 0xA46C, 0x0003, 0xFFFF, 0x0001, 0x2923,
+ 0x0001, 0x10A3, 0x0001, 0x2903, 0x0002, 0x0864, 0x0001, 0x6242, 0x0012, 0xFFFF, 0x0001, 0xCE9B,
+ 0x0001, 0x6A00, 0x0001, 0xA427, 0x0001, 0xEF7E, 0x0002, 0xFFFF, 0x0001, 0x52CD, 0x0001, 0xDCC0,
+ 0x0001, 0x3963, 0x0001, 0x0864, 0x0001, 0x18C4, 0x0001, 0x9B81, 0x0001, 0x7A80, 0x0018, 0xFFFF,
+ 0x0001, 0x3A09, 0x0001, 0xA3A0, 0x0001, 0xFE20, 0x0001, 0xFE00, 0x0001, 0xFE20, 0x0001, 0xF540,
+ 0x0001, 0x18E5, 0x0018, 0xFFFF, 0x0001, 0x8C71, 0x0001, 0x0002, 0x0001, 0x7AE2, 0x0001, 0xB3E1,
+ 0x0001, 0x82E2, 0x0001, 0x0001, 0x0001, 0x9492, 0x0018, 0xFFFF, 0x0001, 0xEF7E, 0x0001, 0x6220,
+ 0x0001, 0x0023, 0x0001, 0x0001, 0x0001, 0x0000, 0x0001, 0x6B4D, 0x0019, 0xFFFF, 0x0001, 0xB50D,
+ 0x0001, 0xFD40, 0x0001, 0xB4EC, 0x0001, 0xC65A, 0x001A, 0xFFFF, 0x0001, 0xD679, 0x0001, 0xAB60,
+ 0x0001, 0xCE37, 0x001C, 0xFFFF, 0x0001, 0xB572, 0x00AB, 0xFFFF};
 
 const int buzz_w = 31;
-const int buzz_h = 32; 
\ No newline at end of file
+const int buzz_h = 32;
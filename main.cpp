@@ -26,9 +26,27 @@ SOFTWARE.
 #include "mbed.h"
 #include "rtos.h"
 #include "TEC.h"
+#include "TecBank.h"
 #include "DcFan.h"
+#include "DcPump.h"
+#include "FanCurve.h"
 #include "FlowSensor.h"
 #include "Thermistor.h"
+#include "FixedThermistor.h"
+#include "PwmQuiet.h"
+#include "thermistor_table.h"
+#include "Biquad.h"
+#include "thermistor_filter.h"
+#include "TempEstimator.h"
+#include "Pid.h"
+#include "FlashStore.h"
+#include "Temperature.h"
+#include "Formatter.h"
+#include "TrendGraph.h"
+#include "DisplayScheduler.h"
+#include "SdLogger.h"
+#include "SdImages.h"
+#include "ui_assets.h"
 
 #include "uLCD_4DGL.h"
 
@@ -51,8 +69,71 @@ FlowSensor ShirtFlow(p17, 1.045);
 // drive a 12V ~1A total PWM signal
 DcFan RadiatorFans(p26, 0.5); // pwm, minimum pwm speed
 
-Thermistor RadiatorThermistor(p19, 3.3, 100000.0, 0.6172273387e-3, 2.287682172e-4, 0.6749479638e-7);
-Thermistor ShirtThermistor(p20, 3.3, 100000.0, 0.6172273387e-3, 2.287682172e-4, 0.6749479638e-7);
+// Optional fan tach lines on p25 and p18, the last spare interrupt capable
+// pins, so only two of the three fans can be monitored.
+// Leave at 0 until the tach wires are connected, otherwise the fans read as
+// stalled and the TECs never turn on.
+#ifndef FAN_TACH_WIRED
+#define FAN_TACH_WIRED 0
+#endif
+
+// Fans only need to move as much air as it takes to keep the radiator near
+// ambient.  No ambient sensor, so assume whichever day starts the fans
+// earlier: a cool one when the radiator is taking heat, a warm one when it
+// is giving it up.  Erring that way only costs some fan noise.
+const float kCoolingAmbientTemp_C = 20.0;
+const float kHeatingAmbientTemp_C = 30.0;
+
+// degrees C the TECs pushed the radiator from ambient, fan speed
+const FanCurve::Point RadiatorFanPoints[] = 
+   {{ 2.0, 0.0},
+    { 3.0, 0.3},
+    { 8.0, 0.6},
+    {15.0, 1.0}};
+
+// fan, curve, points, hysteresis C, fan speed with TECs at full power
+FanCurve RadiatorFanCurve
+   (RadiatorFans,
+    RadiatorFanPoints,
+    sizeof(RadiatorFanPoints) / sizeof(RadiatorFanPoints[0]),
+    1.0,
+    0.5);
+
+// NTC 3950 100K datasheet coefficients, see Thermistor.h.  Replaced at boot
+// by a calibration saved from the console, if there is one, which is why
+// these are Thermistors and not FixedThermistor<Ntc3950>.
+const double kNtcA = 0.6172273387e-3;
+const double kNtcB = 2.287682172e-4;
+const double kNtcC = 0.6749479638e-7;
+Thermistor RadiatorThermistor(p19, 3.3, 100000.0, kNtcA, kNtcB, kNtcC);
+Thermistor ShirtThermistor(p20, 3.3, 100000.0, kNtcA, kNtcB, kNtcC);
+
+// Both thermistors are sampled on SensorThread at the rate the low pass was
+// designed for, see thermistor_filter.h, so pump noise and ADC jitter stay
+// out of the TEC power ramp.  The control loop takes the latest readings.
+// Every raw sample is also checked for a broken sensor, and the TECs and
+// pumps shut down from this thread rather than at the next control pass.
+Thread SensorThread(osPriorityAboveNormal, 1024);
+// The filter only has the response it was designed for at kFilterRate_Hz, so
+// a periodic timer paces the samples however long the reads take
+const int32_t kSampleSignal = 0x01;
+void SampleTick()
+{
+    SensorThread.signal_set(kSampleSignal);
+}
+RtosTimer SampleTimer(SampleTick);
+Biquad RadiatorFilter(kThermistorFilter, kThermistorFilterStages, kThermistorFilterPostShift);
+Biquad ShirtFilter(kThermistorFilter, kThermistorFilterStages, kThermistorFilterPostShift);
+// Each sample is 4^kOversampleBits ADC readings, summed for two more bits
+// than the ADC's 12, each taken between the TEC and fan PWM edges.  The
+// pumps' software PWM isn't avoided.  Each reading waits under two of the
+// TECs' 100 us PWM periods, so the 32 readings for both sensors take under
+// 8 ms of the 20 ms between samples.  tools/adc_enob.py measures the gain.
+const int kOversampleBits = 2;
+PwmQuiet AdcQuiet(2.0, 20.0);   // settle after an edge, one AnalogIn read
+volatile uint16_t RadiatorReading = 0; // filtered read_u16()
+volatile uint16_t ShirtReading    = 0;
+volatile bool     SensorFault     = false; // either thermistor open, shorted or stuck
 
 // Four Thermo Electric Coolers - Peltier devices
 // Using TEC-12706's, mainly because those were readily available and 
@@ -60,20 +141,137 @@ Thermistor ShirtThermistor(p20, 3.3, 100000.0, 0.6172273387e-3, 2.287682172e-4,
 //
 // When choosing a TEC you ideally want one that you will never drive right to 
 // its voltage limit to avoid damage.
-TEC TEC1(p21, p6,  p5);  // PWM, cool pin, heat pin
-TEC TEC2(p22, p8,  p7);  // PWM, cool pin, heat pin
-TEC TEC3(p23, p10, p9);  // PWM, cool pin, heat pin
-TEC TEC4(p24, p12, p11); // PWM, cool pin, heat pin
+//
+// Run as one bank so their PWM on-times are staggered instead of all four
+// H-bridges switching on at the same edge.
+TecBank TECs(p21, p6,  p5,   // PWM, cool pin, heat pin
+             p22, p8,  p7,   // PWM, cool pin, heat pin
+             p23, p10, p9,   // PWM, cool pin, heat pin
+             p24, p12, p11); // PWM, cool pin, heat pin
 
 // DC pumps for circulating water
 // These are 12V basic DC pumps used for acquariums.
 // Not a good idea to run these dry
 // With more budget and more lead time would try to get a better pump,
 // but these should do fine for a demo
-DigitalOut DcRadiatorPump(p30);
-DigitalOut DcShirtPump(p29);
-
-uLCD_4DGL uLCD(p13,p14,p15); // serial tx, serial rx, reset pin;
+//
+// Neither pin has hardware PWM so these run software PWM.
+DcPump DcRadiatorPump(p30, 0.3, 0.5); // pin, minimum speed, soft start speed per second
+DcPump DcShirtPump(p29, 0.3, 0.5);    // pin, minimum speed, soft start speed per second
+
+// Run flat out both loops were heavily over pumped. Hold a flow rate instead,
+// as a fraction of the rated flow.
+const float kMaxPumpFlow_ml_s  = 60.0; // 240 L/hr rated
+const float kRadiatorPumpSpeed = 0.5;
+const float kShirtPumpSpeed    = 0.4;
+
+// Pulsed flow when bleeding air from the loops
+const float kBleedOn_s  = 2.0;
+const float kBleedOff_s = 1.0;
+
+uLCD_4DGL uLCD(p13,p14,p15,false); // serial tx, serial rx, reset pin, init later
+
+// The uLCD takes over 3 seconds to reset.  Bring it up and draw on it from
+// the background so the pumps and TECs are under control right away.
+Thread DisplayThread(osPriorityBelowNormal);
+
+// Display frames may spend half their time sending to the uLCD, anything
+// that doesn't fit waits for the next frame
+const float kDisplayFrame_s = 0.1;
+const int   kDisplayBaud    = 3000000;
+DisplayScheduler DisplayUpdates(uLCD, kDisplayFrame_s, kDisplayBaud, 0.5);
+int StateWidget = -1;
+
+// A uLCD that stops answering is marked offline and the control loop never
+// waits on it.  Look for it again every 5 s, with a hard reset every 4th try
+// in case it is wedged mid command.
+const int kDisplayProbeFrames = 50;
+const int kDisplayResetProbes = 4;
+
+// USB console, typed a line at a time:
+//   lcd              uLCD bytes, answer latency, NAKs and timeouts per opcode
+//   lcd clear        zero those counters
+//   cal              thermistor calibration points and where each fit puts them
+//   cal rad 25.3     take the radiator's reading now as 25.3 C on a reference
+//   cal shirt 25.3   the same for the shirt
+//   cal fit          fit each thermistor with 3 or more points
+//   cal save         keep the coefficients in flash, stalls ~100 ms
+//   cal clear        forget the points, back to the datasheet, erase flash
+//   sensors          health, fault counts, undithered bursts, crowded PWM waits
+char ConsoleLine[32];
+int ConsoleLength = 0;
+volatile bool LcdStatsPrint = false;
+volatile bool LcdStatsClear = false;
+
+// Thermistor calibration against a reference thermometer in the loop
+const int kCalPoints = 8;
+struct CalChannel
+{
+    const char           *Name;
+    Thermistor           &Sensor;
+    volatile uint16_t    &Reading;
+    Thermistor::CalPoint  Points[kCalPoints];
+    int                   Count;
+};
+CalChannel CalChannels[2] =
+   {{"rad",   RadiatorThermistor, RadiatorReading, {{0, 0}}, 0},
+    {"shirt", ShirtThermistor,    ShirtReading,    {{0, 0}}, 0}};
+
+// What goes to flash, change kCalibrationMagic when this changes
+struct SavedCalibration
+{
+    double Coefficients[2][3]; // A, B, C per CalChannels entry
+};
+const uint32_t kCalibrationMagic = 0x50434331; // "PCC1"
+FlashStore CalibrationStore(kCalibrationMagic);
+
+// Ride log on the uLCD microSD card, written a sector at a time by the
+// display thread.  128 MB from 32 MB in holds months at one record a second,
+// tools/sd_log_extract.py turns a card image back into CSV.
+const uint32_t kLogBaseSector = 0x10000;
+const uint32_t kLogSectors    = 0x40000;
+
+// main() to the first committed actuator frame, reported once on the USB serial
+Timer BootTimer;
+
+// Temperature history below the status text, one column per graph refresh
+// lcd, x, y, width, height, bottom C, top C
+TrendGraph TemperatureGraph(uLCD, 0, 80, 128, 48, 10.0, 45.0);
+int ShirtTrace;
+int RadiatorTrace;
+int UserTrace;
+
+// Set to 1 to time text, primitives and BLIT on the uLCD at boot and print
+// bytes/s and ms per call to the USB serial.
+#ifndef LCD_BENCHMARK
+#define LCD_BENCHMARK 0
+#endif
+
+// Set to 1 to count CPU cycles for the double precision temperature path
+// against the fixed point one at boot and print them to the USB serial.
+#ifndef TEMP_BENCHMARK
+#define TEMP_BENCHMARK 0
+#endif
+
+// Set to 1 to count CPU cycles per update for the float, Q31 and Q15 PID
+// controllers at boot and run each against a model of the shirt loop, and
+// print both to the USB serial.
+#ifndef PID_BENCHMARK
+#define PID_BENCHMARK 0
+#endif
+
+// TEC power once running.  0 ramps it down over the last Rampdown_cC before
+// the set point, 1 - 3 run a PID on the shirt temperature: 1 float, 2 Q31
+// on arm_pid_q31, 3 Q15 on arm_pid_q15.  See Pid.h.
+#ifndef TEC_PID
+#define TEC_PID 0
+#endif
+
+// Set to 1 to count CPU cycles for snprintf against Formatter on each of the
+// text lines the firmware writes and print them to the USB serial at boot.
+#ifndef FORMAT_BENCHMARK
+#define FORMAT_BENCHMARK 0
+#endif
 
 enum user_state 
    {kUserOff, 
@@ -124,21 +322,210 @@ const char *boolToStr(bool input)
 // but this should not be considered portable
 //
 volatile user_state UserStateRequested = kUserOff;
-volatile double     UserTemperature_C = 25.5; // 25.5 C, 78 F
+volatile temp_cC    UserTemperature_cC = TEMP_CC(25.5); // 25.5 C, 78 F
 
-const double kMinUserTemperature_C  = 1.0; // Just above freezing
-const double kMaxUserTemperature_C  = 32.0; // About 90 F
-const double kStepUserTemperature_C = 0.5;
+// Temperatures are fixed point hundredths of a degree from the thermistors
+// to the telemetry, see Temperature.h
+const temp_cC kMinUserTemperature_cC  = TEMP_CC(1.0); // Just above freezing
+const temp_cC kMaxUserTemperature_cC  = TEMP_CC(32.0); // About 90 F
+const temp_cC kStepUserTemperature_cC = TEMP_CC(0.5);
 
-const float MaxRadiatorTemp_C = 90.0; // Don't boil coolant!
-const float MinRadiatorTemp_C =  1.0; // Don't freeze coolant (could lower with additive)
+const temp_cC MaxRadiatorTemp_cC = TEMP_CC(90.0); // Don't boil coolant!
+const temp_cC MinRadiatorTemp_cC = TEMP_CC(1.0);  // Don't freeze coolant (could lower with additive)
 
-const float MaxShirtTemp_C     = 40.0; // Never turn on pump when it could burn!
-const float MinShirtTemp_C     =  1.0; // Don't freeze coolant (could lower with additive)
-const float ShirtPreCoolTemp_C =  2.0;
+const temp_cC MaxShirtTemp_cC     = TEMP_CC(40.0); // Never turn on pump when it could burn!
+const temp_cC MinShirtTemp_cC     = TEMP_CC(1.0);  // Don't freeze coolant (could lower with additive)
+const temp_cC ShirtPreCoolTemp_cC = TEMP_CC(2.0);
 
 const double kMinTimeInMode_s = 20.0;
 
+const float kControlPeriod_s = 1.0;
+
+// Filtered temperature and slope of each loop, see TempEstimator.h.  Period,
+// slope at full heating C/s, response s, slope noise C/s, sensor noise C.
+// The gains are rough, the slope noise covers what they miss.  Heating the
+// shirt pumps heat out of the radiator loop, so its gain is negative.
+TempEstimator ShirtEstimate(kControlPeriod_s, 0.02, 20.0, 0.002, 0.05);
+TempEstimator RadiatorEstimate(kControlPeriod_s, -0.01, 30.0, 0.002, 0.05);
+
+// TEC_PID gains, % power per C, per C s, and per C/s, tuned on the shirt
+// model in RunPidBenchmark().  Errors past kTecPidRange_cC, where Kp alone
+// is full power, are clamped.
+const float   kTecKp          = 50.0;
+const float   kTecKi          = 0.2;
+const float   kTecKd          = 400.0;
+const temp_cC kTecPidRange_cC = TEMP_CC(2.0);
+#if TEC_PID == 1
+PidF32 TecController(kTecKp, kTecKi, kTecKd, kControlPeriod_s, kTecPidRange_cC);
+#elif TEC_PID == 2
+PidQ31 TecController(kTecKp, kTecKi, kTecKd, kControlPeriod_s, kTecPidRange_cC);
+#elif TEC_PID == 3
+PidQ15 TecController(kTecKp, kTecKi, kTecKd, kControlPeriod_s, kTecPidRange_cC);
+#endif
+
+// "cal ..." from the console, Args is what follows "cal"
+void console_calibrate(const char *Args)
+{
+    char Line[48];
+    Formatter Text(Line, sizeof(Line));
+    const int Channels = sizeof(CalChannels) / sizeof(CalChannels[0]);
+
+    if (*Args == '\0')
+    {
+        pc.puts("      reading     ref     fit\n");
+        for (int c = 0; c < Channels; c++)
+        {
+            CalChannel &Channel = CalChannels[c];
+            for (int i = 0; i < Channel.Count; i++)
+            {
+                // reading, reference, what the thermistor reads it as now
+                Text.clear();
+                Text.text(Channel.Name, 6).dec(Channel.Points[i].raw, 6)
+                    .fixed(Channel.Points[i].t_cC, kTempDigits, 2, 8)
+                    .fixed(Channel.Sensor.temperature_cC(Channel.Points[i].raw), kTempDigits, 2, 8)
+                    .put('\n');
+                pc.puts(Line);
+            }
+        }
+        return;
+    }
+    if (strcmp(Args, " fit") == 0)
+    {
+        for (int c = 0; c < Channels; c++)
+        {
+            CalChannel &Channel = CalChannels[c];
+            if (Channel.Count == 0)
+            {
+                continue;
+            }
+            Text.clear();
+            Text.text(Channel.Name).text(Channel.Sensor.calibrate(Channel.Points, Channel.Count) ?
+                                         " fitted\n" : " not fitted, need 3 points that agree\n");
+            pc.puts(Line);
+        }
+        return;
+    }
+    if (strcmp(Args, " save") == 0)
+    {
+        SavedCalibration Saved;
+        for (int c = 0; c < Channels; c++)
+        {
+            CalChannels[c].Sensor.get_coefficients
+             (&Saved.Coefficients[c][0],
+              &Saved.Coefficients[c][1],
+              &Saved.Coefficients[c][2]);
+        }
+        pc.puts(CalibrationStore.save(&Saved, sizeof(Saved)) ?
+                "calibration saved\n" : "calibration save failed\n");
+        return;
+    }
+    if (strcmp(Args, " clear") == 0)
+    {
+        for (int c = 0; c < Channels; c++)
+        {
+            CalChannels[c].Count = 0;
+            CalChannels[c].Sensor.coefficients(kNtcA, kNtcB, kNtcC);
+        }
+        CalibrationStore.erase();
+        pc.puts("calibration cleared\n");
+        return;
+    }
+    // " <channel> <temperature>"
+    for (int c = 0; c < Channels; c++)
+    {
+        CalChannel &Channel = CalChannels[c];
+        const int   Length  = strlen(Channel.Name);
+        temp_cC     Reference_cC;
+        if ((Args[0] == ' ') &&
+            (strncmp(Args + 1, Channel.Name, Length) == 0) &&
+            (Args[1 + Length] == ' ') &&
+            temp_parse(Args + 2 + Length, &Reference_cC))
+        {
+            if (Channel.Count >= kCalPoints)
+            {
+                pc.puts("calibration points full, cal fit or cal clear\n");
+                return;
+            }
+            Thermistor::CalPoint &Point = Channel.Points[Channel.Count++];
+            Point.raw  = Channel.Reading;
+            Point.t_cC = Reference_cC;
+            Text.text(Channel.Name).text(" point ").dec(Channel.Count)
+                .text(" reading ").dec(Point.raw).put('\n');
+            pc.puts(Line);
+            return;
+        }
+    }
+    pc.puts("cal, cal rad <C>, cal shirt <C>, cal fit, cal save, cal clear\n");
+}
+
+// "sensors" from the console, each thermistor's health and fault counts,
+// how many samples had too little noise to oversample and how often the
+// ADC couldn't find a quiet gap in the PWM
+void console_sensors()
+{
+    const Thermistor::Health Faults[] =
+       {Thermistor::kHealthOpen,
+        Thermistor::kHealthShort,
+        Thermistor::kHealthStuck,
+        Thermistor::kHealthOutOfRange};
+    for (int c = 0; c < (int)(sizeof(CalChannels) / sizeof(CalChannels[0])); c++)
+    {
+        const Thermistor &Sensor = CalChannels[c].Sensor;
+        char Line[80];
+        Formatter Text(Line, sizeof(Line));
+        Text.text(CalChannels[c].Name).put(' ').text(Thermistor::health_name(Sensor.health()));
+        for (int f = 0; f < (int)(sizeof(Faults) / sizeof(Faults[0])); f++)
+        {
+            Text.put(' ').text(Thermistor::health_name(Faults[f])).put(' ')
+                .dec((int32_t)Sensor.faults(Faults[f]));
+        }
+        Text.text(" undithered ").dec((int32_t)Sensor.undithered()).put('\n');
+        pc.puts(Line);
+    }
+    char Line[40];
+    Formatter Text(Line, sizeof(Line));
+    Text.text("crowded PWM waits ").dec((int32_t)AdcQuiet.crowded()).put('\n');
+    pc.puts(Line);
+}
+
+// Read the USB console without blocking, one command per line.  Polled from
+// the control loop, the UART FIFO holds a typed line between passes.
+void console_poll()
+{
+    while(pc.readable()) {
+        char c = pc.getc();
+        if ((c != '\r') && (c != '\n'))
+        {
+            if (ConsoleLength < (int)sizeof(ConsoleLine) - 1)
+            {
+                ConsoleLine[ConsoleLength++] = c;
+            }
+            continue;
+        }
+        if (ConsoleLength == 0)
+        {
+            continue;
+        }
+        ConsoleLine[ConsoleLength] = '\0';
+        ConsoleLength = 0;
+        if (strcmp(ConsoleLine, "lcd") == 0)
+        {
+            LcdStatsPrint = true;
+        } else if (strcmp(ConsoleLine, "lcd clear") == 0)
+        {
+            LcdStatsClear = true;
+        } else if (strncmp(ConsoleLine, "cal", 3) == 0)
+        {
+            console_calibrate(ConsoleLine + 3);
+        } else if (strcmp(ConsoleLine, "sensors") == 0)
+        {
+            console_sensors();
+        } else {
+            pc.puts("commands: lcd, lcd clear, cal, sensors\n");
+        }
+    }
+}
+
 // control currently setup with bluetooth.  Using UART based bluetooth with AdaFruit App.
 //
 // Buttons are laid out like this:
@@ -189,9 +576,9 @@ void bluetooth_recv()
                 {
                     if(bluetoothLE.getc() == '1')
                     {
-                       if (UserTemperature_C < kMaxUserTemperature_C)
+                       if (UserTemperature_cC < kMaxUserTemperature_cC)
                        {
-                          UserTemperature_C += kStepUserTemperature_C;
+                          UserTemperature_cC += kStepUserTemperature_cC;
                        }
                     }
                 }
@@ -199,9 +586,9 @@ void bluetooth_recv()
                 {
                     if(bluetoothLE.getc() == '1')
                     {
-                       if (UserTemperature_C > kMinUserTemperature_C)
+                       if (UserTemperature_cC > kMinUserTemperature_cC)
                        {
-                          UserTemperature_C -= kStepUserTemperature_C;
+                          UserTemperature_cC -= kStepUserTemperature_cC;
                        }
                     }
                 }
@@ -210,25 +597,106 @@ void bluetooth_recv()
     }
 }
 
-void SetClimate
-    (TEC::TecAction ThisClimateState,
-     float          TecPowerPercent) // 0.0 to 100.0, as a % of max power
+// Everything the control loop wants the outputs to be.  The state machine
+// stages a frame each pass and CommitActuators() applies it in one place.
+struct ActuatorFrame
+{
+    TEC::TecAction ClimateState;
+    float          TecPowerPercent;     // 0.0 to 100.0, as a % of max power
+    float          RadiatorPumpSpeed;   // 0.0 to 1.0
+    float          ShirtPumpSpeed;      // 0.0 to 1.0
+    bool           BleedPumps;          // pulse pumps to shake air out
+    bool           RadiatorFansEnabled; // run the fan curve
+};
+
+// The TECs and pumps are driven from the control loop and, on a broken
+// sensor, from SensorThread.  Whoever holds this owns them.
+Mutex ActuatorMutex;
+bool  RecommitActuators = true; // outputs changed behind CommitActuators()
+
+// Apply a frame, only touching outputs that changed since the last commit.
+// All 4 TECs change together: direction pins in one port write, PWM windows
+// latched at the next PWM period.
+void CommitActuators
+    (const ActuatorFrame &Staged,
+     temp_cC              RadiatorTemperature_cC)
 {
-    // Set all 4 TECs the same
-    TEC1.setClimate
-    (ThisClimateState,
-     TecPowerPercent);
-    TEC2.setClimate
-    (ThisClimateState,
-     TecPowerPercent);
-    TEC3.setClimate
-    (ThisClimateState,
-     TecPowerPercent);
-    TEC4.setClimate
-    (ThisClimateState,
-     TecPowerPercent);
+    static ActuatorFrame Committed;
+
+    ActuatorMutex.lock();
+    // A frame staged before a sensor broke mustn't turn things back on
+    ActuatorFrame Frame = Staged;
+    if (SensorFault)
+    {
+        Frame.ClimateState      = TEC::Cooling;
+        Frame.TecPowerPercent   = 0.0;
+        Frame.RadiatorPumpSpeed = 0.0;
+        Frame.ShirtPumpSpeed    = 0.0;
+        Frame.BleedPumps        = false;
+    }
+    const bool FirstCommit = RecommitActuators;
 
-}    
+    if (FirstCommit ||
+        (Frame.ClimateState    != Committed.ClimateState) ||
+        (Frame.TecPowerPercent != Committed.TecPowerPercent))
+    {
+        TECs.setClimate
+        (Frame.ClimateState,
+         Frame.TecPowerPercent);
+    }
+
+    // Pulse before speed so a bleed starts with the pump on
+    if (FirstCommit || (Frame.BleedPumps != Committed.BleedPumps))
+    {
+        if(Frame.BleedPumps)
+        {
+            DcRadiatorPump.pulse(kBleedOn_s, kBleedOff_s);
+            DcShirtPump.pulse(kBleedOn_s, kBleedOff_s);
+        } else {
+            DcRadiatorPump.pulse(0.0, 0.0);
+            DcShirtPump.pulse(0.0, 0.0);
+        }
+    }
+    if (FirstCommit || (Frame.RadiatorPumpSpeed != Committed.RadiatorPumpSpeed))
+    {
+        DcRadiatorPump.speed(Frame.RadiatorPumpSpeed);
+    }
+    if (FirstCommit || (Frame.ShirtPumpSpeed != Committed.ShirtPumpSpeed))
+    {
+        DcShirtPump.speed(Frame.ShirtPumpSpeed);
+    }
+
+    // Fan curve follows temperature, so it runs every pass.  DcFan only
+    // rewrites the PWM when the speed actually changes.
+    if(Frame.RadiatorFansEnabled)
+    {
+        RadiatorFanCurve.update
+         (Frame.ClimateState,
+          temp_to_C(RadiatorTemperature_cC),
+          (Frame.ClimateState == TEC::Heating) ? kHeatingAmbientTemp_C : kCoolingAmbientTemp_C,
+          Frame.TecPowerPercent);
+    } else {
+        RadiatorFanCurve.off();
+    }
+
+    Committed         = Frame;
+    RecommitActuators = false;
+    ActuatorMutex.unlock();
+}
+
+// Remove TEC power and stop both pumps now, from any thread.  The next
+// CommitActuators() applies its whole frame again.
+void ActuatorsOff()
+{
+    ActuatorMutex.lock();
+    TECs.setClimate(TEC::Cooling, 0.0);
+    DcRadiatorPump.pulse(0.0, 0.0);
+    DcShirtPump.pulse(0.0, 0.0);
+    DcRadiatorPump.speed(0.0);
+    DcShirtPump.speed(0.0);
+    RecommitActuators = true;
+    ActuatorMutex.unlock();
+}
 
 enum system_state 
    {kSystemOff, 
@@ -286,26 +754,64 @@ const char* TecActionToStr(TEC::TecAction input)
 }
 
 time_t         TimeModeEntered_s    = 0;
-double         PreUserTemperature_C = UserTemperature_C;
+temp_cC        PreUserTemperature_cC = UserTemperature_cC;
 TEC::TecAction ClimateState         = TEC::Cooling;
 
+// Latest control loop values for the display widgets on DisplayThread
+struct DisplayStatus
+{
+    user_state     UserState;
+    system_state   SystemState;
+    TEC::TecAction ClimateState;
+    float          TecPowerPercent;
+    temp_cC        ShirtTemperature_cC;
+    temp_cC        RadiatorTemperature_cC;
+    int32_t        RadiatorFlow_ml;
+    int32_t        ShirtFlow_ml;
+};
+DisplayStatus Status;
+Mutex         StatusMutex;
+
+// One control pass on the SD card, 20 bytes, layout shared with
+// tools/sd_log_extract.py
+struct LogRecord
+{
+    uint32_t Time_s;
+    int16_t  UserTemperature_cC;     // hundredths of a degree C
+    int16_t  ShirtTemperature_cC;
+    int16_t  RadiatorTemperature_cC;
+    uint8_t  UserState;
+    uint8_t  SystemState;
+    uint8_t  ClimateState;
+    uint8_t  TecPowerPercent;
+    uint16_t RadiatorFlow_ml;
+    uint16_t ShirtFlow_ml;
+    uint8_t  FanPercent;
+    uint8_t  Flags;                  // kLogBleeding, kLogFansStalled, kLogSensorFault
+};
+const uint8_t kLogBleeding    = 0x01;
+const uint8_t kLogFansStalled = 0x02;
+const uint8_t kLogSensorFault = 0x04;
+
+SdLogger RideLog(uLCD, kLogBaseSector, kLogSectors, sizeof(LogRecord));
+
+// Labels, state names and setpoint digits pre-rendered on the microSD card
+// by tools/ui_assets.py, text is printed instead if the card doesn't match
+SdImages UiImages(uLCD, kUiAssetSector, kUiAssetBuildId, kUiAssetCount);
+const int kSetpointX = 38;
+const int kSetpointY = 24;
+temp_cC SetpointDrawn_cC = TEMP_CC(-1000.0);  // what the big digits show now
+
 
 system_state TransitionSystemState
     (system_state SystemState,
-     float        RadiatorTemperature_C,
-     float        ShirtTemperature_C)
+     bool         RadiatorTempOkay,
+     bool         ShirtTempOkay)
 {
     time_t CurrentTime_s = time(NULL);
     
     system_state ThisSystemState = SystemState;
 
-    bool RadiatorTempOkay = 
-        (RadiatorTemperature_C >= MinRadiatorTemp_C) &&
-        (RadiatorTemperature_C <= MaxRadiatorTemp_C);
-    bool ShirtTempOkay =
-        (ShirtTemperature_C >= MinShirtTemp_C) &&
-        (ShirtTemperature_C <= MaxShirtTemp_C);
-
     // DC pump rated for 240L / hr
     // That would be over 60 mL a second
     // Accept a fraction of that without considering the pump compromized.
@@ -333,6 +839,9 @@ system_state TransitionSystemState
     
     bool RadiatorPumpOkay = (CurrentTime_s - RadiatorPumpLastGood_s <= CheckPumpTime_s);
     bool ShirtPumpOkay    = (CurrentTime_s - ShirtPumpLastGood_s <= CheckPumpTime_s);
+
+    // Always okay without tachs
+    bool RadiatorFansOkay = !RadiatorFans.stalled();
     
     
 //    pc.printf("\n\nShirt Temp OK? %s\n", boolToStr(ShirtTempOkay));
@@ -344,10 +853,10 @@ system_state TransitionSystemState
 
     //pc.printf("%4.1f %4.1f ", ShirtFlow_ml, RadiatorFlow_ml);
 
-    uLCD.locate(11,6);
-    uLCD.printf("% 3.0fml", RadiatorFlow_ml);
-    uLCD.locate(11,7);
-    uLCD.printf("% 3.0fml", ShirtFlow_ml);
+    StatusMutex.lock();
+    Status.RadiatorFlow_ml = (int32_t)(RadiatorFlow_ml + 0.5);
+    Status.ShirtFlow_ml    = (int32_t)(ShirtFlow_ml + 0.5);
+    StatusMutex.unlock();
 
     switch(UserStateRequested) 
     {
@@ -377,8 +886,8 @@ system_state TransitionSystemState
                     if (ThisSystemState == kSystemCooling)
                     {
                         // Already been in Running State for min time.
-                        // Start checking pumps.
-                        if (!RadiatorPumpOkay || !ShirtPumpOkay)
+                        // Start checking pumps and fans.
+                        if (!RadiatorPumpOkay || !ShirtPumpOkay || !RadiatorFansOkay)
                         {
                             // Shut down for a bit
                             ThisSystemState = kSystemCoolCoast;
@@ -414,8 +923,8 @@ system_state TransitionSystemState
                     if (ThisSystemState == kSystemHeating)
                     {
                         // Already been in Running State for min time.
-                        // Start checking pumps.
-                        if (!RadiatorPumpOkay || !ShirtPumpOkay)
+                        // Start checking pumps and fans.
+                        if (!RadiatorPumpOkay || !ShirtPumpOkay || !RadiatorFansOkay)
                         {
                             // Shut down for a bit
                             ThisSystemState = kSystemHeatCoast;
@@ -501,7 +1010,101 @@ system_state TransitionSystemState
     return ThisSystemState;
 }
 
-void Periodic_Processing()
+// "radiator shirt user shirt/min radiator/min radiator_faults shirt_faults\n",
+// temperatures in degrees C to one decimal, how fast the shirt and radiator
+// are changing in degrees C per minute, then how many times each thermistor
+// has faulted, the line the phone app and SerialPlot graph
+int FormatTelemetry
+    (char     *Line,
+     int       Size,
+     temp_cC   Radiator_cC,
+     temp_cC   Shirt_cC,
+     temp_cC   User_cC,
+     int32_t   ShirtSlope_cC_min,
+     int32_t   RadiatorSlope_cC_min,
+     uint32_t  RadiatorFaults,
+     uint32_t  ShirtFaults)
+{
+    Formatter Text(Line, Size);
+    Text.fixed(Radiator_cC, kTempDigits, 1, 3).put(' ')
+        .fixed(Shirt_cC, kTempDigits, 1, 3).put(' ')
+        .fixed(User_cC, kTempDigits, 1, 3).put(' ')
+        .fixed(ShirtSlope_cC_min, kTempDigits, 2).put(' ')
+        .fixed(RadiatorSlope_cC_min, kTempDigits, 2).put(' ')
+        .dec((int32_t)RadiatorFaults).put(' ')
+        .dec((int32_t)ShirtFaults).put('\n');
+    return Text.length();
+}
+
+// "  24.4oC " for the temperature rows of the uLCD
+int FormatDisplayTemperature
+    (char    *Line,
+     int      Size,
+     temp_cC  Temperature_cC)
+{
+    Formatter Text(Line, Size);
+    Text.fixed(Temperature_cC, kTempDigits, 1, 5).text("oC ");
+    return Text.length();
+}
+
+// "Cooling  100%   " for the bottom row of the uLCD
+int FormatStateLine
+    (char           *Line,
+     int             Size,
+     TEC::TecAction  Action,
+     int32_t         Percent)
+{
+    Formatter Text(Line, Size);
+    Text.text(TecActionToStr(Action)).put(' ').dec(Percent, 4).text("%   ");
+    return Text.length();
+}
+
+// One raw ADC reading through a filter, back out as a read_u16() value
+uint16_t FilterReading
+    (Biquad   &Filter,
+     uint16_t  Raw)
+{
+    int32_t Filtered = Filter.filter((int32_t)Raw << kFilterInputShift);
+    Filtered = (Filtered + (1 << (kFilterInputShift - 1))) >> kFilterInputShift;
+    if (Filtered < 0)
+    {
+        Filtered = 0;
+    } else if (Filtered > 65535)
+    {
+        Filtered = 65535;
+    }
+    return (uint16_t)Filtered;
+}
+
+// Runs on SensorThread
+void SensorTask()
+{
+    while (true)
+    {
+        Thread::signal_wait(kSampleSignal);
+        const uint16_t RadiatorRaw = RadiatorThermistor.read_u16();
+        const uint16_t ShirtRaw    = ShirtThermistor.read_u16();
+        RadiatorThermistor.check(RadiatorRaw);
+        ShirtThermistor.check(ShirtRaw);
+        RadiatorReading = FilterReading(RadiatorFilter, RadiatorRaw);
+        ShirtReading    = FilterReading(ShirtFilter, ShirtRaw);
+
+        // Shut down on this sample, not at the next control pass, which may
+        // be blocked on a UART or in flash
+        const bool Fault = RadiatorThermistor.sensor_fault() || ShirtThermistor.sensor_fault();
+        if (Fault && !SensorFault)
+        {
+            SensorFault = true;
+            ActuatorsOff();
+        } else if (!Fault)
+        {
+            SensorFault = false;
+        }
+    }
+}
+
+// Period_s is the time since the last pass started, as measured
+void Periodic_Processing(float Period_s)
 {
     static system_state SystemState           = kSystemOff;
     
@@ -512,23 +1115,59 @@ void Periodic_Processing()
     
     // Reset every time
     bool                  EnableFanSeparately = false;
+    bool                  BleedPumps          = false;
 
     // If we can't keep within this amount of the goal try coasting and doing
     // another mini cool down.
-    const float           FallingBehind_C     = 5.0;
+    const temp_cC         FallingBehind_cC    = TEMP_CC(5.0);
     // This is the number of degrees overwhich we ramp power down to 0%
-    const float           Rampdown_C          = 2.0;
+    const temp_cC         Rampdown_cC         = TEMP_CC(2.0);
     // Precool/preheat up to 5 minutes
     const double          kPreTime_s          = 60.0 * 5.0; 
     // Heat or Cool without shirt pump for a while
     const double          kSmallCycleTime_s   = 30.0;
+    // Power ramps down on where the shirt will be this far ahead, so it
+    // comes off before the set point is crossed rather than after
+    const float           kAnticipate_s       = 20.0;
     
     time_t CurrentTime_s = time(NULL);
 
+#if TEC_PID
+    // First pass in a state, the PID picks up from the power it was left at
+    static system_state LastSystemState = kSystemOff;
+    const bool StateEntered = (SystemState != LastSystemState);
+    LastSystemState = SystemState;
+#endif
+
     // Check for temperature overruns
     
-    float RadiatorTemperature_C = RadiatorThermistor.temperature_C();
-    float ShirtTemperature_C    = ShirtThermistor.temperature_C();
+    // Latest filtered reading each.  The limits were turned into ADC readings
+    // at start up, see main(), so the checks are integer compares on the reading.
+    const uint16_t RadiatorRaw = RadiatorReading;
+    const uint16_t ShirtRaw    = ShirtReading;
+    // A broken sensor reads as anything, so it is never okay whatever the
+    // filtered reading says.
+    const bool SensorFault      = ::SensorFault;
+    const bool RadiatorTempOkay = RadiatorThermistor.in_limits(RadiatorRaw) &&
+                                  !RadiatorThermistor.sensor_fault();
+    const bool ShirtTempOkay    = ShirtThermistor.in_limits(ShirtRaw) &&
+                                  !ShirtThermistor.sensor_fault();
+
+    // Estimates across the last pass, with the TEC power it ran at.  Heating
+    // is positive, and a loop only feels the TECs with its pump running.
+    const float TecInput = 
+        ((ClimateState == TEC::Heating) ? 1.0 : -1.0) * TecPowerPercent / 100.0;
+    RadiatorEstimate.update
+     (RadiatorThermistor.temperature_cC(RadiatorRaw),
+      RadiatorPumpEnabled ? TecInput : 0.0);
+    ShirtEstimate.update
+     (ShirtThermistor.temperature_cC(ShirtRaw),
+      ShirtPumpEnabled ? TecInput : 0.0);
+    temp_cC RadiatorTemperature_cC = RadiatorEstimate.temperature_cC();
+    temp_cC ShirtTemperature_cC    = ShirtEstimate.temperature_cC();
+    const temp_cC ShirtAhead_cC    = ShirtEstimate.predict_cC(kAnticipate_s);
+    // The phone may change the set point mid pass, use one value throughout
+    const temp_cC UserTemperature_cC = ::UserTemperature_cC;
 
     // basic state machine
     switch(SystemState)
@@ -543,8 +1182,8 @@ void Periodic_Processing()
             SystemState = 
                 TransitionSystemState
                     (SystemState,
-                     RadiatorTemperature_C,
-                     ShirtTemperature_C);
+                     RadiatorTempOkay,
+                     ShirtTempOkay);
             break;
 
         case kSystemPrecool:
@@ -557,10 +1196,10 @@ void Periodic_Processing()
             SystemState = 
                 TransitionSystemState
                     (SystemState,
-                     RadiatorTemperature_C,
-                     ShirtTemperature_C);
+                     RadiatorTempOkay,
+                     ShirtTempOkay);
 
-            if(ShirtTemperature_C <= ShirtPreCoolTemp_C)
+            if(ShirtTemperature_cC <= ShirtPreCoolTemp_cC)
             {
                 SystemState       = kSystemCooling;
                 TimeModeEntered_s = CurrentTime_s;
@@ -584,10 +1223,10 @@ void Periodic_Processing()
             SystemState = 
                 TransitionSystemState
                     (SystemState,
-                     RadiatorTemperature_C,
-                     ShirtTemperature_C);            
+                     RadiatorTempOkay,
+                     ShirtTempOkay);            
             
-            if(ShirtTemperature_C >= UserTemperature_C + Rampdown_C)
+            if(ShirtTemperature_cC >= UserTemperature_cC + Rampdown_cC)
             {
                 SystemState       = kSystemHeating;
                 TimeModeEntered_s = CurrentTime_s;    
@@ -607,7 +1246,7 @@ void Periodic_Processing()
             ShirtPumpEnabled    = true;
             ClimateState = TEC::Cooling;
             if((CurrentTime_s - TimeModeEntered_s > kSmallCycleTime_s) && 
-                (ShirtTemperature_C > UserTemperature_C + FallingBehind_C))
+                (ShirtTemperature_cC > UserTemperature_cC + FallingBehind_cC))
             {
                 // Not keeping up
                 // turn off shirt pump and attempt to chill a bit
@@ -616,23 +1255,36 @@ void Periodic_Processing()
                 SystemState = kSystemCoolDown; //kSystemCoolCoast;
                 TimeModeEntered_s = CurrentTime_s;
                 break;
-            } else if (ShirtTemperature_C > UserTemperature_C)
+            }
+#if TEC_PID
+            // Warmer than asked for wants more cooling
+            if (StateEntered)
+            {
+                TecController.reset
+                 (ShirtTemperature_cC - UserTemperature_cC,
+                  (int32_t)(TecPowerPercent * 100.0));
+            }
+            TecPowerPercent = 
+                TecController.update(ShirtTemperature_cC - UserTemperature_cC) / 100.0;
+#else
+            if (ShirtAhead_cC > UserTemperature_cC)
             {
                 TecPowerPercent = 100.0;
-            } else if (abs(ShirtTemperature_C - UserTemperature_C) <= Rampdown_C)
+            } else if (temp_abs(ShirtAhead_cC - UserTemperature_cC) <= Rampdown_cC)
             {
                 TecPowerPercent = 
-                    100.0 * (abs(ShirtTemperature_C - UserTemperature_C) / Rampdown_C);
+                    (100 * temp_abs(ShirtAhead_cC - UserTemperature_cC)) / Rampdown_cC;
             } else
             {
                 TecPowerPercent = 0.0;
             }
+#endif
             
             SystemState = 
                 TransitionSystemState
                     (SystemState,
-                     RadiatorTemperature_C,
-                     ShirtTemperature_C);
+                     RadiatorTempOkay,
+                     ShirtTempOkay);
             break;
 
         case kSystemHeating:
@@ -641,7 +1293,7 @@ void Periodic_Processing()
             ShirtPumpEnabled    = true;
             ClimateState = TEC::Heating;
             if((CurrentTime_s - TimeModeEntered_s > kSmallCycleTime_s) &&
-                (ShirtTemperature_C < UserTemperature_C - FallingBehind_C))
+                (ShirtTemperature_cC < UserTemperature_cC - FallingBehind_cC))
             {
                 // Not keeping up
                 // turn off pump and attempt to heat up a bit
@@ -650,23 +1302,36 @@ void Periodic_Processing()
                 SystemState = kSystemHeatUp; // kSystemHeatCoast;
                 TimeModeEntered_s = CurrentTime_s;
                 break;             
-            } else if (ShirtTemperature_C < UserTemperature_C)
+            }
+#if TEC_PID
+            // Colder than asked for wants more heating
+            if (StateEntered)
+            {
+                TecController.reset
+                 (UserTemperature_cC - ShirtTemperature_cC,
+                  (int32_t)(TecPowerPercent * 100.0));
+            }
+            TecPowerPercent = 
+                TecController.update(UserTemperature_cC - ShirtTemperature_cC) / 100.0;
+#else
+            if (ShirtAhead_cC < UserTemperature_cC)
             {
                 TecPowerPercent = 100.0;
-            } else if (abs(ShirtTemperature_C - UserTemperature_C) <= Rampdown_C)
+            } else if (temp_abs(ShirtAhead_cC - UserTemperature_cC) <= Rampdown_cC)
             {
                 TecPowerPercent = 
-                    100.0 * (abs(ShirtTemperature_C - UserTemperature_C) / Rampdown_C);
+                    (100 * temp_abs(ShirtAhead_cC - UserTemperature_cC)) / Rampdown_cC;
             } else
             {
                 TecPowerPercent = 0.0;
             }
+#endif
             
             SystemState = 
                 TransitionSystemState
                     (SystemState,
-                     RadiatorTemperature_C,
-                     ShirtTemperature_C);
+                     RadiatorTempOkay,
+                     ShirtTempOkay);
             break;
             
         case kSystemCoolDown:
@@ -676,7 +1341,7 @@ void Periodic_Processing()
             ClimateState = TEC::Cooling;
             TecPowerPercent = 100.0;
 
-            if(ShirtTemperature_C <= ShirtPreCoolTemp_C)
+            if(ShirtTemperature_cC <= ShirtPreCoolTemp_cC)
             {
                 SystemState       = kSystemCooling;
                 TimeModeEntered_s = CurrentTime_s;
@@ -691,8 +1356,8 @@ void Periodic_Processing()
             SystemState = 
                 TransitionSystemState
                     (SystemState,
-                     RadiatorTemperature_C,
-                     ShirtTemperature_C);
+                     RadiatorTempOkay,
+                     ShirtTempOkay);
             break;
 
         case kSystemCoolCoast:
@@ -712,8 +1377,8 @@ void Periodic_Processing()
             SystemState = 
                 TransitionSystemState
                     (SystemState,
-                     RadiatorTemperature_C,
-                     ShirtTemperature_C);
+                     RadiatorTempOkay,
+                     ShirtTempOkay);
             break;
 
         case kSystemHeatUp:
@@ -722,7 +1387,7 @@ void Periodic_Processing()
             ShirtPumpEnabled    = false;
             ClimateState = TEC::Heating;
             TecPowerPercent = 100.0;
-            if(ShirtTemperature_C >= UserTemperature_C + Rampdown_C)
+            if(ShirtTemperature_cC >= UserTemperature_cC + Rampdown_cC)
             {
                 SystemState       = kSystemHeating;
                 TimeModeEntered_s = CurrentTime_s;
@@ -735,8 +1400,8 @@ void Periodic_Processing()
             SystemState = 
                 TransitionSystemState
                     (SystemState,
-                     RadiatorTemperature_C,
-                     ShirtTemperature_C);
+                     RadiatorTempOkay,
+                     ShirtTempOkay);
             break;
             
         case kSystemHeatCoast:
@@ -756,8 +1421,8 @@ void Periodic_Processing()
             SystemState = 
                 TransitionSystemState
                     (SystemState,
-                     RadiatorTemperature_C,
-                     ShirtTemperature_C);
+                     RadiatorTempOkay,
+                     ShirtTempOkay);
             break;
 
         case kSystemRunRadiatorPump:
@@ -767,11 +1432,12 @@ void Periodic_Processing()
             // Turn off pumps
             RadiatorPumpEnabled = true;
             ShirtPumpEnabled    = false;
+            BleedPumps          = true;
             SystemState = 
                 TransitionSystemState
                     (SystemState,
-                     RadiatorTemperature_C,
-                     ShirtTemperature_C);
+                     RadiatorTempOkay,
+                     ShirtTempOkay);
             break;
 
         case kSystemRunShirtPump:
@@ -781,110 +1447,759 @@ void Periodic_Processing()
             // Turn off pumps
             RadiatorPumpEnabled = false;
             ShirtPumpEnabled    = true;
+            BleedPumps          = true;
             SystemState = 
                 TransitionSystemState
                     (SystemState,
-                     RadiatorTemperature_C,
-                     ShirtTemperature_C);
+                     RadiatorTempOkay,
+                     ShirtTempOkay);
             break;
     }
 
+    // The states above go to kSystemOff on a bad temperature but run their
+    // outputs one more pass, don't for a broken sensor
+    if (SensorFault)
+    {
+        SystemState         = kSystemOff;
+        ClimateState        = TEC::Cooling;
+        TecPowerPercent     = 0.0;
+        RadiatorPumpEnabled = false;
+        ShirtPumpEnabled    = false;
+        EnableFanSeparately = false;
+        BleedPumps          = false;
+        TimeModeEntered_s   = CurrentTime_s;
+    }
+
     // One place to actually set system outputs
-    
-    // Set TEC states
-    SetClimate
-     (ClimateState,
-      TecPowerPercent);
+    ActuatorFrame Frame;
+    Frame.ClimateState        = ClimateState;
+    Frame.TecPowerPercent     = TecPowerPercent;
+    Frame.BleedPumps          = BleedPumps;
+    // Fans only help when water is moving through the radiator,
+    // or when the cold/hot side needs to settle with the pump off.
+    Frame.RadiatorFansEnabled = RadiatorPumpEnabled || EnableFanSeparately;
 
-    // Set Pumps
     if(RadiatorPumpEnabled)
     {
-        DcRadiatorPump = 1;
-        // tie fan speed to TEC percent power.
-        // fan speed has a minimum value
-        // Was originally scaling with power output of TEC, but it seems to work
-        // better if the fans just run when the radiator pump is active.
-        RadiatorFans.speed(100.0);
+        Frame.RadiatorPumpSpeed = BleedPumps ? 1.0 : kRadiatorPumpSpeed;
     } else {
-        DcRadiatorPump = 0;
-        if(EnableFanSeparately)
+        Frame.RadiatorPumpSpeed = 0.0;
+    }
+    if(ShirtPumpEnabled)
+    {
+        Frame.ShirtPumpSpeed = BleedPumps ? 1.0 : kShirtPumpSpeed;
+    } else {
+        Frame.ShirtPumpSpeed = 0.0;
+    }
+
+    CommitActuators
+     (Frame,
+      RadiatorTemperature_cC);
+
+    static bool FirstTick = true;
+    if (FirstTick)
+    {
+        char Line[48];
+        Formatter Text(Line, sizeof(Line));
+        Text.text("Boot to first control tick ").dec(BootTimer.read_us()).text(" us\n");
+        pc.puts(Line);
+        FirstTick = false;
+    }
+
+    // Closed loop fan trim and stall check, read back next pass
+    RadiatorFans.update(Period_s);
+    
+    // Closed loop flow trim, the pumps are shared with ActuatorsOff()
+    ActuatorMutex.lock();
+    DcRadiatorPump.update(Period_s);
+    DcShirtPump.update(Period_s);
+    ActuatorMutex.unlock();
+
+    // Hand the status to the display, the state text only redraws on change
+    StatusMutex.lock();
+    const bool StateChanged =
+        (Status.UserState            != UserStateRequested) ||
+        (Status.SystemState          != SystemState) ||
+        (Status.ClimateState         != ClimateState) ||
+        ((int)Status.TecPowerPercent != (int)TecPowerPercent);
+    Status.UserState             = UserStateRequested;
+    Status.SystemState           = SystemState;
+    Status.ClimateState          = ClimateState;
+    Status.TecPowerPercent       = TecPowerPercent;
+    Status.ShirtTemperature_cC    = ShirtTemperature_cC;
+    Status.RadiatorTemperature_cC = RadiatorTemperature_cC;
+
+    LogRecord Record;
+    Record.Time_s                 = time(NULL);
+    Record.UserTemperature_cC     = (int16_t)UserTemperature_cC;
+    Record.ShirtTemperature_cC    = (int16_t)ShirtTemperature_cC;
+    Record.RadiatorTemperature_cC = (int16_t)RadiatorTemperature_cC;
+    Record.UserState              = UserStateRequested;
+    Record.SystemState            = SystemState;
+    Record.ClimateState           = ClimateState;
+    Record.TecPowerPercent        = (uint8_t)TecPowerPercent;
+    Record.RadiatorFlow_ml        = (uint16_t)Status.RadiatorFlow_ml;
+    Record.ShirtFlow_ml           = (uint16_t)Status.ShirtFlow_ml;
+    StatusMutex.unlock();
+    Record.FanPercent             = (uint8_t)(RadiatorFans.current_speed() * 100.0);
+    Record.Flags                  = (BleedPumps ? kLogBleeding : 0) |
+                                    (RadiatorFans.stalled() ? kLogFansStalled : 0) |
+                                    (SensorFault ? kLogSensorFault : 0);
+    RideLog.log(&Record);
+
+    if (StateChanged)
+    {
+        DisplayUpdates.mark(StateWidget);
+        // Get the ride onto the card when the user turns it off
+        if (UserStateRequested == kUserOff)
         {
-            RadiatorFans.speed(100.0);
+            RideLog.sync();
         }
-        else
-        {   
-            RadiatorFans.speed(0.0);
+    }
+
+    // stream temps to phone and the USB serial to PC, formatted once
+    char Telemetry[64];
+    FormatTelemetry
+     (Telemetry,
+      sizeof(Telemetry),
+      RadiatorTemperature_cC,
+      ShirtTemperature_cC,
+      UserTemperature_cC,
+      ShirtEstimate.slope_cC_min(),
+      RadiatorEstimate.slope_cC_min(),
+      RadiatorThermistor.fault_total(),
+      ShirtThermistor.fault_total());
+    bluetoothLE.puts(Telemetry);
+    pc.puts(Telemetry);
+    console_poll();
+}
+
+#if TEMP_BENCHMARK || FORMAT_BENCHMARK || PID_BENCHMARK
+// Cycles from the Cortex-M3 DWT cycle counter, DWT->CYCCNT
+void CycleCounterStart()
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL  |= DWT_CTRL_CYCCNTENA_Msk;
+}
+#endif
+
+#if TEMP_BENCHMARK
+// Cycles per call, the loop overhead is included in both columns
+void RunTemperatureBenchmark()
+{
+    const int kRepeats = 100;
+    uint32_t  Start;
+    uint32_t  Double;
+    uint32_t  Fixed;
+
+    CycleCounterStart();
+
+    pc.printf("\nTemperature benchmark, cycles per call, double vs fixed\n");
+
+    // Thermistor read, ADC conversion included in both
+    volatile double  Sink_C;
+    volatile temp_cC Sink_cC;
+    Start = DWT->CYCCNT;
+    for (int i = 0; i < kRepeats; i++)
+    {
+        Sink_C = ShirtThermistor.temperature_C();
+    }
+    Double = (DWT->CYCCNT - Start) / kRepeats;
+    Start = DWT->CYCCNT;
+    for (int i = 0; i < kRepeats; i++)
+    {
+        Sink_cC = ShirtThermistor.temperature_cC();
+    }
+    Fixed = (DWT->CYCCNT - Start) / kRepeats;
+    pc.printf("read     %7lu %7lu\n", (unsigned long)Double, (unsigned long)Fixed);
+
+    // Ramp down decision and power from Periodic_Processing()
+    volatile double  Shirt_C  = 24.37;
+    volatile double  User_C   = 25.5;
+    volatile temp_cC Shirt_cC = TEMP_CC(24.37);
+    volatile temp_cC User_cC  = TEMP_CC(25.5);
+    volatile float   Percent;
+    Start = DWT->CYCCNT;
+    for (int i = 0; i < kRepeats; i++)
+    {
+        if (fabs(Shirt_C - User_C) <= 2.0)
+        {
+            Percent = 100.0 * (fabs(Shirt_C - User_C) / 2.0);
         }
     }
-    
-    if(ShirtPumpEnabled)
+    Double = (DWT->CYCCNT - Start) / kRepeats;
+    Start = DWT->CYCCNT;
+    for (int i = 0; i < kRepeats; i++)
     {
-        DcShirtPump = 1;
-    } else {
-        DcShirtPump = 0;
-    }
-
-    // Update status output
-    //uLCD.BLIT(x, y, buzz_w, buzz_h, (int *)buzz); 
-    uLCD.locate(5,1);
-    uLCD.printf("%s", UserStateToStr(UserStateRequested));
-    uLCD.locate(5,2);
-    uLCD.printf("%s", SystemStateToStr(SystemState));
-    uLCD.locate(7,3);
-    uLCD.printf("% 3.1foC ", UserTemperature_C);
-    uLCD.locate(7,4);
-    uLCD.printf("% 3.1foC ", ShirtTemperature_C);
-    uLCD.locate(7,5);
-    uLCD.printf("% 3.1foC ", RadiatorTemperature_C);
-    uLCD.locate(0,8);
-    uLCD.printf("%s % 3.0f%%   ", TecActionToStr(ClimateState), TecPowerPercent);
+        if (temp_abs(Shirt_cC - User_cC) <= TEMP_CC(2.0))
+        {
+            Percent = (100 * temp_abs(Shirt_cC - User_cC)) / TEMP_CC(2.0);
+        }
+    }
+    Fixed = (DWT->CYCCNT - Start) / kRepeats;
+    pc.printf("rampdown %7lu %7lu\n", (unsigned long)Double, (unsigned long)Fixed);
 
-    // stream temps to phone
-    bluetoothLE.printf("%3.1f %3.1f %3.1f\n", RadiatorTemperature_C, ShirtTemperature_C, UserTemperature_C);
+    // Runtime coefficients and a RAM table against build time ones and a
+    // flash table, same curve.  "create" is the start up cost of each.
+    pc.puts("\nThermistor vs FixedThermistor<Ntc3950>, cycles per call\n");
+    Start = DWT->CYCCNT;
+    {
+        Thermistor Probe(p20, 3.3, 100000.0, kNtcA, kNtcB, kNtcC);
+        Double = DWT->CYCCNT - Start;
+        Sink_cC = Probe.temperature_cC((uint16_t)0x8000);
+    }
+    Start = DWT->CYCCNT;
+    {
+        FixedThermistor<Ntc3950> Probe(p20);
+        Fixed = DWT->CYCCNT - Start;
+        Sink_cC = Probe.temperature_cC((uint16_t)0x8000);
+    }
+    pc.printf("create   %7lu %7lu\n", (unsigned long)Double, (unsigned long)Fixed);
 
-    // USB serial to PC
-    pc.printf("%3.1f %3.1f %3.1f\n", RadiatorTemperature_C, ShirtTemperature_C, UserTemperature_C);
+    FixedThermistor<Ntc3950> FixedShirt(p20);
+    volatile uint16_t Raw = 0x6123;
+    Start = DWT->CYCCNT;
+    for (int i = 0; i < kRepeats; i++)
+    {
+        Sink_cC = ShirtThermistor.temperature_cC((uint16_t)Raw);
+    }
+    Double = (DWT->CYCCNT - Start) / kRepeats;
+    Start = DWT->CYCCNT;
+    for (int i = 0; i < kRepeats; i++)
+    {
+        Sink_cC = FixedShirt.temperature_cC((uint16_t)Raw);
+    }
+    Fixed = (DWT->CYCCNT - Start) / kRepeats;
+    pc.printf("convert  %7lu %7lu\n", (unsigned long)Double, (unsigned long)Fixed);
+    pc.printf("RAM      %7lu %7lu bytes\n",
+              (unsigned long)sizeof(Thermistor), (unsigned long)sizeof(FixedThermistor<Ntc3950>));
+
+    (void)Sink_C;
+    (void)Sink_cC;
+    (void)Percent;
 }
+#endif
+
+#if FORMAT_BENCHMARK
+// Cycles per formatted line, snprintf as the firmware used to write it
+// against Formatter, loop overhead included in both columns.  Build once with
+// and once without FORMAT_BENCHMARK and diff the .map files for the flash
+// the float printf costs, this function is the only %f left in the image.
+void RunFormatBenchmark()
+{
+    const int kRepeats = 100;
+    uint32_t  Start;
+    uint32_t  Printf;
+    uint32_t  Fixed;
+    char      Line[64];
+
+    volatile double   Shirt_C   = 24.37;
+    volatile double   User_C    = 25.5;
+    volatile double   Percent   = 100.0;
+    volatile temp_cC  Shirt_cC  = TEMP_CC(24.37);
+    volatile temp_cC  User_cC   = TEMP_CC(25.5);
+    volatile int32_t  Percent_i = 100;
+    volatile double   Slope_C   = -0.45;
+    volatile int32_t  Slope_cC  = -45;
+    volatile uint32_t Faults    = 0;
+
+    CycleCounterStart();
+
+    pc.puts("\nFormat benchmark, cycles per line, snprintf vs Formatter\n");
+
+    // Telemetry to the phone and the USB serial
+    Start = DWT->CYCCNT;
+    for (int i = 0; i < kRepeats; i++)
+    {
+        snprintf(Line, sizeof(Line), "%3.1f %3.1f %3.1f %.2f %.2f %u %u\n",
+                 (double)Shirt_C, (double)Shirt_C, (double)User_C, (double)Slope_C, (double)Slope_C,
+                 (unsigned)Faults, (unsigned)Faults);
+    }
+    Printf = (DWT->CYCCNT - Start) / kRepeats;
+    Start = DWT->CYCCNT;
+    for (int i = 0; i < kRepeats; i++)
+    {
+        FormatTelemetry(Line, sizeof(Line), Shirt_cC, Shirt_cC, User_cC, Slope_cC, Slope_cC, Faults, Faults);
+    }
+    Fixed = (DWT->CYCCNT - Start) / kRepeats;
+    pc.printf("telemetry   %7lu %7lu\n", (unsigned long)Printf, (unsigned long)Fixed);
 
+    // uLCD temperature row
+    Start = DWT->CYCCNT;
+    for (int i = 0; i < kRepeats; i++)
+    {
+        snprintf(Line, sizeof(Line), "% 3.1foC ", (double)Shirt_C);
+    }
+    Printf = (DWT->CYCCNT - Start) / kRepeats;
+    Start = DWT->CYCCNT;
+    for (int i = 0; i < kRepeats; i++)
+    {
+        FormatDisplayTemperature(Line, sizeof(Line), Shirt_cC);
+    }
+    Fixed = (DWT->CYCCNT - Start) / kRepeats;
+    pc.printf("temperature %7lu %7lu\n", (unsigned long)Printf, (unsigned long)Fixed);
 
-int main()
+    // uLCD state row
+    Start = DWT->CYCCNT;
+    for (int i = 0; i < kRepeats; i++)
+    {
+        snprintf(Line, sizeof(Line), "%s % 3.0f%%   ", TecActionToStr(TEC::Cooling), (double)Percent);
+    }
+    Printf = (DWT->CYCCNT - Start) / kRepeats;
+    Start = DWT->CYCCNT;
+    for (int i = 0; i < kRepeats; i++)
+    {
+        FormatStateLine(Line, sizeof(Line), TEC::Cooling, Percent_i);
+    }
+    Fixed = (DWT->CYCCNT - Start) / kRepeats;
+    pc.printf("state       %7lu %7lu\n", (unsigned long)Printf, (unsigned long)Fixed);
+}
+#endif
+
+#if PID_BENCHMARK
+// Cycles per update(), errors swept over the range so no branch is always
+// taken, loop overhead included
+template <class Controller>
+uint32_t PidUpdateCycles(Controller &Pid)
 {
-    // Initialize time, Don't need it to be correct, just for relative time stamps
-    set_time(0);
+    const int kRepeats = 100;
+    volatile int32_t Sink;
+    Pid.reset(0, PidDesign::kPowerFull / 2);
+    const uint32_t Start = DWT->CYCCNT;
+    for (int i = 0; i < kRepeats; i++)
+    {
+        Sink = Pid.update((i % 41 - 20) * 10);
+    }
+    (void)Sink;
+    return (DWT->CYCCNT - Start) / kRepeats;
+}
+
+// Cools the shirt model from 30 C to 25 C, against body heat worth half the
+// TECs, with ShirtEstimate's gain and response.  A float controller fed the
+// same errors alongside shows how far the power strays from it.
+template <class Controller>
+void PidStepResponse(const char *Name, Controller &Pid, uint32_t Cycles)
+{
+    const int     kSeconds   = 1200;
+    const int     kRmsFrom_s = 800;
+    const temp_cC Set_cC     = TEMP_CC(25.0);
+    PidF32 Reference(kTecKp, kTecKi, kTecKd, kControlPeriod_s, kTecPidRange_cC);
+
+    float    Shirt_C       = 30.0;
+    float    Slope_C_s     = 0.0;
+    int32_t  Settle_s      = -1;
+    temp_cC  Undershoot_cC = 0;
+    float    Squares       = 0.0;
+    int32_t  PowerDiff     = 0;
+    Pid.reset(TEMP_CC(Shirt_C) - Set_cC, PidDesign::kPowerFull);
+    Reference.reset(TEMP_CC(Shirt_C) - Set_cC, PidDesign::kPowerFull);
+    for (int t = 0; t < kSeconds; t++)
+    {
+        const temp_cC Error_cC = TEMP_CC(Shirt_C) - Set_cC;
+        const int32_t Power    = Pid.update(Error_cC);
+        const int32_t Diff     = Power - Reference.update(Error_cC);
+        PowerDiff = (Diff > PowerDiff) ? Diff : (-Diff > PowerDiff) ? -Diff : PowerDiff;
+
+        const float Input = 0.5 - (float)Power / PidDesign::kPowerFull;
+        Slope_C_s += (0.02 * Input - Slope_C_s) * kControlPeriod_s / 20.0;
+        Shirt_C   += Slope_C_s * kControlPeriod_s;
+
+        Undershoot_cC = (-Error_cC > Undershoot_cC) ? -Error_cC : Undershoot_cC;
+        if (temp_abs(Error_cC) > TEMP_CC(0.2))
+        {
+            Settle_s = -1;
+        } else if (Settle_s < 0)
+        {
+            Settle_s = t;
+        }
+        if (t >= kRmsFrom_s)
+        {
+            Squares += temp_to_C(Error_cC) * temp_to_C(Error_cC);
+        }
+    }
+
+    char Line[64];
+    Formatter Text(Line, sizeof(Line));
+    Text.text(Name, 8).dec(Cycles, 7).dec(Settle_s, 9)
+        .fixed(Undershoot_cC, kTempDigits, 2, 8)
+        .fixed(TEMP_CC(sqrtf(Squares / (kSeconds - kRmsFrom_s))), kTempDigits, 2, 8)
+        .fixed(PowerDiff, 2, 2, 8).put('\n');
+    pc.puts(Line);
+}
+
+void RunPidBenchmark()
+{
+    PidF32 Float(kTecKp, kTecKi, kTecKd, kControlPeriod_s, kTecPidRange_cC);
+    PidQ31 Q31(kTecKp, kTecKi, kTecKd, kControlPeriod_s, kTecPidRange_cC);
+    PidQ15 Q15(kTecKp, kTecKi, kTecKd, kControlPeriod_s, kTecPidRange_cC);
+
+    CycleCounterStart();
+    const uint32_t FloatCycles = PidUpdateCycles(Float);
+    const uint32_t Q31Cycles   = PidUpdateCycles(Q31);
+    const uint32_t Q15Cycles   = PidUpdateCycles(Q15);
+
+    pc.puts("\nPID benchmark, the shirt model cooled from 30 C to 25 C\n");
+    pc.puts("         cycles settle s under C   rms C power %\n");
+    PidStepResponse("f32", Float, FloatCycles);
+    PidStepResponse("q31", Q31, Q31Cycles);
+    PidStepResponse("q15", Q15, Q15Cycles);
+}
+#endif
+
+
+#if LCD_BENCHMARK
+#include "buzz.h"
+
+void LcdBenchmarkReport
+    (const char  *Name,
+     int          Calls,
+     unsigned int StartBytes,
+     Timer       &BenchTimer)
+{
+    const float        Elapsed_s = BenchTimer.read();
+    const unsigned int Bytes     = uLCD.bytes_sent - StartBytes;
+    pc.printf("%-6s %6u bytes %8.0f bytes/s %7.2f ms/call\n",
+              Name, Bytes, Bytes / Elapsed_s, 1000.0 * Elapsed_s / Calls);
+}
+
+void RunLcdBenchmark()
+{
+    const int    kRepeats = 20;
+    Timer        BenchTimer;
+    unsigned int StartBytes;
+
+    pc.printf("\nuLCD benchmark, chunk %d bytes, %d us wait\n", TX_CHUNK, TX_CHUNK_WAIT_US);
+
+    // Text, same shape as a status line
+    StartBytes = uLCD.bytes_sent;
+    BenchTimer.reset();
+    BenchTimer.start();
+    for (int i = 0; i < kRepeats; i++)
+    {
+        uLCD.locate(7,10);
+        uLCD.printf("% 3.1foC ", 25.5);
+    }
+    BenchTimer.stop();
+    LcdBenchmarkReport("text", kRepeats, StartBytes, BenchTimer);
+
+    // Primitives, one command each
+    StartBytes = uLCD.bytes_sent;
+    BenchTimer.reset();
+    BenchTimer.start();
+    for (int i = 0; i < kRepeats; i++)
+    {
+        uLCD.line(0, 100, 127, 100 + (i % 20), 0x00FF00);
+        uLCD.rectangle(10, 100, 60, 120, 0xFF0000);
+        uLCD.filled_rectangle(70, 100, 120, 120, 0x0000FF);
+    }
+    BenchTimer.stop();
+    LcdBenchmarkReport("prim", 3 * kRepeats, StartBytes, BenchTimer);
+
+    // BLIT, one 31 x 32 sprite per call
+    StartBytes = uLCD.bytes_sent;
+    BenchTimer.reset();
+    BenchTimer.start();
+    for (int i = 0; i < kRepeats; i++)
+    {
+        uLCD.BLIT_RLE(48, 48, buzz_w, buzz_h, buzz);
+    }
+    BenchTimer.stop();
+    LcdBenchmarkReport("BLIT", kRepeats, StartBytes, BenchTimer);
 
-    // uLCD setup
     uLCD.cls();
-    uLCD.baudrate(3000000); //jack up baud rate to max for fast display
+}
+#endif
+
+// Display widgets, run by DisplayUpdates on DisplayThread
+DisplayStatus ReadStatus()
+{
+    StatusMutex.lock();
+    DisplayStatus Copy = Status;
+    StatusMutex.unlock();
+    return Copy;
+}
+
+void DrawState()
+{
+    const DisplayStatus Now = ReadStatus();
+    //uLCD.BLIT_RLE(x, y, buzz_w, buzz_h, buzz); 
+    if (UiImages.ready())
+    {
+        UiImages.draw(kUiUserOff + Now.UserState, 35, 8);
+        UiImages.draw(kUiSystemOff + Now.SystemState, 35, 16);
+    } else {
+        uLCD.locate(5,1);
+        uLCD.puts(UserStateToStr(Now.UserState));
+        uLCD.locate(5,2);
+        uLCD.puts(SystemStateToStr(Now.SystemState));
+    }
+    char Line[24];
+    FormatStateLine(Line, sizeof(Line), Now.ClimateState, (int32_t)Now.TecPowerPercent);
+    uLCD.locate(0,9);
+    uLCD.puts(Line);
+}
+
+// Large digits from the card, only redrawn when the setpoint changes
+void DrawSetpoint(temp_cC Setpoint_cC)
+{
+    if (Setpoint_cC == SetpointDrawn_cC)
+    {
+        return;
+    }
+    SetpointDrawn_cC = Setpoint_cC;
+
+    char Text[12];
+    if (!UiImages.ready())
+    {
+        FormatDisplayTemperature(Text, sizeof(Text), Setpoint_cC);
+        uLCD.locate(7,3);
+        uLCD.puts(Text);
+        return;
+    }
+    temp_format(Text, sizeof(Text), Setpoint_cC, 4, 1);
+    int x = kSetpointX;
+    for (const char *c = Text; *c != '\0'; c++)
+    {
+        int Image = kUiDigitBlank;
+        if ((*c >= '0') && (*c <= '9'))
+        {
+            Image = kUiDigit0 + (*c - '0');
+        } else if (*c == '.')
+        {
+            Image = kUiDigitPoint;
+        } else if (*c == '-')
+        {
+            Image = kUiDigitMinus;
+        }
+        UiImages.draw(Image, x, kSetpointY);
+        x += kUiDigitWidth;
+    }
+    UiImages.draw(kUiDegreesC, x, kSetpointY);
+}
+
+void DrawTemperatures()
+{
+    const DisplayStatus Now = ReadStatus();
+    // The set point comes straight from the phone, show it without waiting
+    // for the control loop
+    DrawSetpoint(UserTemperature_cC);
+    char Text[12];
+    FormatDisplayTemperature(Text, sizeof(Text), Now.ShirtTemperature_cC);
+    uLCD.locate(7,5);
+    uLCD.puts(Text);
+    FormatDisplayTemperature(Text, sizeof(Text), Now.RadiatorTemperature_cC);
+    uLCD.locate(7,6);
+    uLCD.puts(Text);
+}
+
+void DrawFlow()
+{
+    const DisplayStatus Now = ReadStatus();
+    char Text[12];
+    Formatter Flow(Text, sizeof(Text));
+    Flow.dec(Now.RadiatorFlow_ml, 4).text("ml");
+    uLCD.locate(11,7);
+    uLCD.puts(Text);
+    Flow.clear();
+    Flow.dec(Now.ShirtFlow_ml, 4).text("ml");
+    uLCD.locate(11,8);
+    uLCD.puts(Text);
+}
+
+void DrawGraph()
+{
+    const DisplayStatus Now = ReadStatus();
+    TemperatureGraph.sample(ShirtTrace, temp_to_C(Now.ShirtTemperature_cC));
+    TemperatureGraph.sample(RadiatorTrace, temp_to_C(Now.RadiatorTemperature_cC));
+    TemperatureGraph.sample(UserTrace, temp_to_C(UserTemperature_cC));
+    TemperatureGraph.update();
+}
+
+// Everything on the screen from scratch, at boot and whenever the uLCD
+// comes back after going offline
+void DisplayRedraw()
+{
+    uLCD.baudrate(kDisplayBaud); //jack up baud rate to max for fast display
     uLCD.background_color(0x000000);
     uLCD.cls();    
     uLCD.textbackground_color(0x000000);
     uLCD.text_width(1); //1X size text
     uLCD.text_height(1);
-    
-    // Print the static display
-    uLCD.locate(0,1);
-    uLCD.printf("Req:");
-    uLCD.locate(0,2);
-    uLCD.printf("Sys:");
-    uLCD.locate(0,3);
-    uLCD.printf("User:");
-    uLCD.locate(0,4);
-    uLCD.printf("Shirt:");
-    uLCD.locate(0,5);
-    uLCD.printf("Rad:");
-    uLCD.locate(0,6);
-    uLCD.printf("Rad Flow:");
-    uLCD.locate(0,7);
-    uLCD.printf("Shirt Flow:");
 
+    // Print the static display, one image if the card has it.  The setpoint
+    // takes rows 3 and 4.
+    if (UiImages.start())
+    {
+        UiImages.draw(kUiLabels, 0, 8);
+    } else {
+        uLCD.locate(0,1);
+        uLCD.puts("Req:");
+        uLCD.locate(0,2);
+        uLCD.puts("Sys:");
+        uLCD.locate(0,3);
+        uLCD.puts("User:");
+        uLCD.locate(0,5);
+        uLCD.puts("Shirt:");
+        uLCD.locate(0,6);
+        uLCD.puts("Rad:");
+        uLCD.locate(0,7);
+        uLCD.puts("Rad Flow:");
+        uLCD.locate(0,8);
+        uLCD.puts("Shirt Flow:");
+    }
+    TemperatureGraph.redraw();
+
+    // and every widget on the next frames
+    SetpointDrawn_cC = TEMP_CC(-1000.0);
+    DisplayUpdates.mark_all();
+}
+
+// Runs on DisplayThread, everything here may take seconds
+void DisplayInit()
+{
+    // uLCD setup
+    uLCD.init();
+
+#if LCD_BENCHMARK
+    uLCD.baudrate(kDisplayBaud);
+    RunLcdBenchmark();
+#endif
+
+    UserTrace     = TemperatureGraph.add_trace(DGREY);
+    RadiatorTrace = TemperatureGraph.add_trace(RED);
+    ShirtTrace    = TemperatureGraph.add_trace(GREEN);
+
+    // widget, priority, refresh s (0 only when marked)
+    StateWidget = DisplayUpdates.add(DrawState, 4, 0.0);
+    DisplayUpdates.add(DrawTemperatures, 3, 0.5);
+    DisplayUpdates.add(DrawFlow, 2, 1.0);
+    DisplayUpdates.add(DrawGraph, 1, 5.0);
+    DisplayUpdates.add(callback(&RideLog, &SdLogger::service), 0, 1.0);
+
+    DisplayRedraw();
+}
+
+void DisplayTask()
+{
+    int OfflineFrames = 0;
+    int Probes = 0;
+
+    DisplayInit();
+    while(1) {
+        // Console requests, handled here so the counters are only touched
+        // between commands
+        if (LcdStatsClear)
+        {
+            uLCD.clear_stats();
+            LcdStatsClear = false;
+        }
+        if (LcdStatsPrint)
+        {
+            uLCD.print_stats(pc);
+            LcdStatsPrint = false;
+        }
+
+        if (uLCD.online())
+        {
+            DisplayUpdates.run_frame();
+        } else if (++OfflineFrames >= kDisplayProbeFrames)
+        {
+            OfflineFrames = 0;
+            if (++Probes >= kDisplayResetProbes)
+            {
+                Probes = 0;
+                uLCD.init();
+            }
+            if (uLCD.probe())
+            {
+                pc.puts("uLCD back online\n");
+                Probes = 0;
+                DisplayRedraw();
+            }
+        }
+        Thread::wait(kDisplayFrame_s * 1000);
+    }
+}
+
+int main()
+{
+    BootTimer.start();
+
+    // Initialize time, Don't need it to be correct, just for relative time stamps
+    set_time(0);
+
+    // A calibration from the console replaces the datasheet coefficients
+    SavedCalibration Saved;
+    if (CalibrationStore.load(&Saved, sizeof(Saved)))
+    {
+        for (int c = 0; c < (int)(sizeof(CalChannels) / sizeof(CalChannels[0])); c++)
+        {
+            CalChannels[c].Sensor.coefficients
+             (Saved.Coefficients[c][0],
+              Saved.Coefficients[c][1],
+              Saved.Coefficients[c][2]);
+        }
+        pc.puts("thermistor calibration loaded\n");
+    }
+
+    // Safe coolant range as thermistor ADC readings, checked every pass
+    RadiatorThermistor.limits(MinRadiatorTemp_cC, MaxRadiatorTemp_cC);
+    ShirtThermistor.limits(MinShirtTemp_cC, MaxShirtTemp_cC);
+    RadiatorThermistor.oversample(kOversampleBits, &AdcQuiet);
+    ShirtThermistor.oversample(kOversampleBits, &AdcQuiet);
+
+    // Start the filters from a first reading rather than ramping up from 0
+    RadiatorReading = RadiatorThermistor.read_u16();
+    ShirtReading    = ShirtThermistor.read_u16();
+    RadiatorFilter.reset((int32_t)RadiatorReading << kFilterInputShift);
+    ShirtFilter.reset((int32_t)ShirtReading << kFilterInputShift);
+    SensorThread.start(SensorTask);
+    SampleTimer.start(1000.0 / kFilterRate_Hz);
+
+    DisplayThread.start(DisplayTask);
+
+    // Fans hold 0.3 once spinning, but need a half second shove to get going
+    RadiatorFans.kick_start(0.5, 0.3);
+    // flow sensor, flow at full speed, gain
+    DcRadiatorPump.closed_loop(RadiatorFlow, kMaxPumpFlow_ml_s, 0.2);
+    DcShirtPump.closed_loop(ShirtFlow, kMaxPumpFlow_ml_s, 0.2);
+
+#if FAN_TACH_WIRED
+    RadiatorFans.add_tach(p25, 2); // tach pin, pulses per revolution
+    RadiatorFans.add_tach(p18, 2);
+    RadiatorFans.closed_loop(1800.0, 0.5); // rpm at full speed, gain
+#endif
 
     // Bluetooth UART setup    
     bluetoothLE.baud(9600);
     bluetoothLE.attach(&bluetooth_recv, Serial::RxIrq);    
 
+#if TEMP_BENCHMARK
+    RunTemperatureBenchmark();
+#endif
+#if FORMAT_BENCHMARK
+    RunFormatBenchmark();
+#endif
+#if PID_BENCHMARK
+    RunPidBenchmark();
+#endif
+
+    // Hold the period from one pass start to the next, however long a pass
+    // spends on the UARTs or in flash.  The estimators and the PID count on
+    // kControlPeriod_s between passes.
+    Timer PassTimer;
+    PassTimer.start();
+    float Period_s = kControlPeriod_s;
     while(1) {
-        Periodic_Processing();
-        Thread::wait(1000);
+        Periodic_Processing(Period_s);
+        const int Wait_ms = (int)(kControlPeriod_s * 1000) - PassTimer.read_ms();
+        if (Wait_ms > 0)
+        {
+            Thread::wait(Wait_ms);
+        }
+        Period_s = PassTimer.read();
+        PassTimer.reset();
     }
 }
 
@@ -0,0 +1,14 @@
+// Biquad low pass coefficients, CMSIS DF1 Q31 layout
+// Generated by tools/biquad_design.py --fs 50 --filter Thermistor:0.5:2
+
+// Rate the filters were designed for, run them at this rate
+const float kFilterRate_Hz = 50.0;
+// Readings are shifted up this far going in and back down coming out
+const int kFilterInputShift = 14;
+
+// Thermistor, 4 pole Butterworth, 0.5 Hz cutoff
+const int kThermistorFilterStages    = 2;
+const int kThermistorFilterPostShift = 1;
+const int32_t kThermistorFilter[] =
+   {    1034533,     2069067,     1034533,  2092954698, -1023351008,
+        1001305,     2002611,     1001305,  2025731614,  -955995012};
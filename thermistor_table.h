@@ -0,0 +1,28 @@
+// Thermistor lookup table in flash, for FixedThermistor<Ntc3950>
+// Generated by tools/thermistor_table.py --name Ntc3950 --r1 100000.0 --a 0.0006172273387 --b 0.0002287682172 --c 6.749479638e-08 --steps 128
+
+// Hundredths of a degree C at read_u16() = i << kTableShift
+const temp_cC kNtc3950Table[129] =
+   { 15000,  15000,  15000,  13844,  12669,  11792,  11097,  10522,
+     10032,   9607,   9230,   8893,   8587,   8308,   8051,   7812,
+      7590,   7381,   7185,   6999,   6823,   6656,   6496,   6343,
+      6197,   6056,   5921,   5790,   5664,   5541,   5423,   5307,
+      5196,   5087,   4980,   4877,   4776,   4677,   4580,   4485,
+      4392,   4301,   4211,   4123,   4036,   3951,   3867,   3784,
+      3702,   3621,   3542,   3463,   3385,   3308,   3231,   3156,
+      3081,   3007,   2933,   2860,   2787,   2715,   2643,   2571,
+      2500,   2429,   2359,   2288,   2218,   2148,   2078,   2008,
+      1938,   1869,   1799,   1729,   1659,   1589,   1519,   1448,
+      1378,   1307,   1235,   1164,   1092,   1019,    946,    873,
+       798,    723,    648,    571,    494,    416,    337,    256,
+       175,     92,      8,    -78,   -166,   -255,   -346,   -439,
+      -534,   -632,   -733,   -837,   -944,  -1055,  -1169,  -1289,
+     -1413,  -1543,  -1680,  -1824,  -1977,  -2140,  -2316,  -2505,
+     -2713,  -2942,  -3201,  -3499,  -3852,  -4291,  -4883,  -5500,
+     -5500};
+
+struct Ntc3950
+{
+    enum { kTableShift = 9 };
+    static const temp_cC *table() { return kNtc3950Table; }
+};
@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+"""Measure what Thermistor::oversample() gains on synthetic noisy readings.
+
+Copyright 2020 Jonathan L. Martin <jon.martini@gmail.com>
+
+MIT license, see LICENSE.
+
+Models the LPC1768 ADC as a 12 bit quantizer with Gaussian noise, including
+the median of three readings the mbed HAL takes for every read_u16(), and
+runs each reading through the oversample and decimate of
+Thermistor::read_u16() bit for bit.  Reports the effective number of bits
+for each noise level and oversample setting, how often a burst counts as
+dithered(), and the resolution that means in degrees C at 25 C:
+
+  python3 tools/adc_enob.py --noise 0 0.25 0.5 1 2 --bits 0 1 2 3 4
+
+ENOB comes from the rms error against the true input, scaled so an ideal 12
+bit converter with no noise scores 12.  Keep MIN_DITHER_CODES in step with
+Thermistor.h.
+"""
+
+import argparse
+import math
+import random
+
+MIN_DITHER_CODES = 1
+MAX_OVERSAMPLE_BITS = 4
+
+
+def adc_code(x, sigma, median, rng):
+    """One read_u16() >> 4, the ADC's 12 bits."""
+    def convert():
+        return max(0, min(4095, int(math.floor(x + rng.gauss(0.0, sigma) + 0.5)) if sigma else int(math.floor(x + 0.5))))
+    if not median:
+        return convert()
+    return sorted([convert(), convert(), convert()])[1]
+
+
+def read_u16(x, sigma, bits, median, rng):
+    """Thermistor::read_u16() with oversample(bits), and whether the burst
+    was dithered()."""
+    codes = [adc_code(x, sigma, median, rng) for _ in range(1 << (2 * bits))]
+    shift = 2 * bits
+    average = ((sum(codes) << 4) + ((1 << shift) >> 1)) >> shift
+    raw = average + (average >> 12)
+    return raw, max(codes) - min(codes) >= MIN_DITHER_CODES
+
+
+def measure(sigma, bits, median, trials, rng):
+    squares = 0.0
+    dithered = 0
+    for _ in range(trials):
+        # Anywhere between codes, away from the rails
+        x = rng.uniform(256.0, 3840.0)
+        raw, ok = read_u16(x, sigma, bits, median, rng)
+        ideal = x * 65535.0 / 4095.0
+        squares += (raw - ideal) ** 2
+        dithered += 1 if ok else 0
+    rms = math.sqrt(squares / trials)
+    # An ideal 12 bit quantizer has rms error 16 / sqrt(12) in read_u16() counts
+    enob = 16.0 - math.log2(rms * math.sqrt(12.0)) if rms > 0 else 16.0
+    return enob, rms, dithered / float(trials)
+
+
+def c_per_count(r1, a, b, c, celsius):
+    """Degrees C per read_u16() count at a temperature, from Steinhart-Hart."""
+    def temp(raw):
+        ln_r = math.log(r1 * raw / (65536.0 - raw))
+        return 1.0 / (a + b * ln_r + c * ln_r ** 3) - 273.15
+    lo, hi = 1.0, 65535.0
+    for _ in range(60):
+        mid = (lo + hi) / 2.0
+        if temp(mid) > celsius:
+            lo = mid
+        else:
+            hi = mid
+    return abs(temp(lo + 8.0) - temp(lo - 8.0)) / 16.0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('--noise', type=float, nargs='+', default=[0.0, 0.25, 0.5, 1.0, 2.0],
+                        help='ADC noise, rms codes')
+    parser.add_argument('--bits', type=int, nargs='+', default=list(range(MAX_OVERSAMPLE_BITS + 1)),
+                        help='oversample() settings to try')
+    parser.add_argument('--trials', type=int, default=2000, help='readings per setting')
+    parser.add_argument('--no-median', action='store_true', help='no median of three in the HAL')
+    parser.add_argument('--r1', type=float, default=100000.0, help='pull up, Ohms')
+    parser.add_argument('--a', type=float, default=0.6172273387e-3, help='Steinhart-Hart A')
+    parser.add_argument('--b', type=float, default=2.287682172e-4, help='Steinhart-Hart B')
+    parser.add_argument('--c', type=float, default=0.6749479638e-7, help='Steinhart-Hart C')
+    parser.add_argument('--seed', type=int, default=1, help='noise seed, for repeatable runs')
+    args = parser.parse_args()
+    if any(b < 0 or b > MAX_OVERSAMPLE_BITS for b in args.bits):
+        parser.error('--bits run 0 to %d' % MAX_OVERSAMPLE_BITS)
+
+    rng = random.Random(args.seed)
+    median = not args.no_median
+    per_count = c_per_count(args.r1, args.a, args.b, args.c, 25.0)
+    print('ENOB, rms error in C at 25 C (%.4f C per read_u16() count) and %% of bursts dithered()'
+          % per_count)
+    print('median of 3 per reading: %s, %d readings per setting' % ('yes' if median else 'no', args.trials))
+    print('%8s  %s' % ('noise', '  '.join('%20s' % ('bits %d, %d reads' % (b, 1 << (2 * b))) for b in args.bits)))
+    for sigma in args.noise:
+        cells = []
+        for bits in args.bits:
+            enob, rms, dithered = measure(sigma, bits, median, args.trials, rng)
+            cells.append('%5.2f %6.3fC %4.0f%%' % (enob, rms * per_count, dithered * 100.0)
+                         if bits else '%5.2f %6.3fC      ' % (enob, rms * per_count))
+        print('%8.2f  %s' % (sigma, '  '.join('%20s' % cell for cell in cells)))
+
+
+if __name__ == '__main__':
+    main()
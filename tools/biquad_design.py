@@ -0,0 +1,295 @@
+#!/usr/bin/env python3
+"""Design the thermistor low pass filter and check its frequency response.
+
+Copyright 2020 Jonathan L. Martin <jon.martini@gmail.com>
+
+MIT license, see LICENSE.
+
+Designs Butterworth low pass filters as cascades of biquads, quantizes them
+to the Q31 layout Biquad and arm_biquad_cascade_df1_q31 take (b0, b1, b2,
+a1, a2 per stage, a1 and a2 negated, all scaled down by 2^postShift) and
+writes the header the firmware builds against:
+
+  python3 tools/biquad_design.py --fs 50 --filter Thermistor:0.5:2 \\
+      --header thermistor_filter.h
+
+Each --filter is NAME:CUTOFF_HZ:STAGES, give one per channel that needs its
+own response.  Every filter is then run bit for bit as the firmware runs it,
+on sine waves and on a full scale step, and the tool exits non zero if the
+measured gain strays from the design or the step overflows Q31.
+
+--firmware also builds Biquad/Biquad.cpp for the host with c++ and runs the
+same sine waves and steps through it, so the check covers the code the
+firmware actually runs and not only this model of it:
+
+  python3 tools/biquad_design.py --fs 50 --filter Thermistor:0.5:2 --firmware
+"""
+
+import argparse
+import cmath
+import math
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+# Readings go into the filter shifted up this far, see FilterReading() in
+# main.cpp, leaving a bit of headroom for overshoot
+INPUT_SHIFT = 14
+FULL_SCALE = 65535 << INPUT_SHIFT
+
+GAIN_TOLERANCE_DB = 0.1
+CHECK_FLOOR_DB = -60.0
+
+
+def butterworth(fs, fc, stages):
+    """Biquads of a 2 * stages order Butterworth low pass, as
+    (b0, b1, b2, a1, a2) with a0 = 1 and the usual signs."""
+    w0 = 2.0 * math.pi * fc / fs
+    order = 2 * stages
+    sections = []
+    for k in range(stages):
+        q = 1.0 / (2.0 * math.sin((2 * k + 1) * math.pi / (2 * order)))
+        alpha = math.sin(w0) / (2.0 * q)
+        cos_w0 = math.cos(w0)
+        a0 = 1.0 + alpha
+        sections.append(((1.0 - cos_w0) / 2.0 / a0, (1.0 - cos_w0) / a0, (1.0 - cos_w0) / 2.0 / a0,
+                         -2.0 * cos_w0 / a0, (1.0 - alpha) / a0))
+    return sections
+
+
+def quantize(sections):
+    """CMSIS DF1 Q31 coefficients and the post shift that fits them."""
+    largest = max(max(abs(c) for c in s) for s in sections)
+    post_shift = 0
+    while largest >= (1 << post_shift):
+        post_shift += 1
+    scale = float(1 << (31 - post_shift))
+    coefficients = []
+    for b0, b1, b2, a1, a2 in sections:
+        for c in (b0, b1, b2, -a1, -a2):
+            coefficients.append(max(-(1 << 31), min((1 << 31) - 1, int(round(c * scale)))))
+    return coefficients, post_shift
+
+
+def response(sections, f, fs):
+    z = cmath.exp(-2j * math.pi * f / fs)
+    h = 1.0
+    for b0, b1, b2, a1, a2 in sections:
+        h *= (b0 + b1 * z + b2 * z * z) / (1.0 + a1 * z + a2 * z * z)
+    return abs(h)
+
+
+def run(coefficients, post_shift, samples):
+    """Biquad::filter() in integers, returns the outputs and the largest
+    magnitude any stage produced."""
+    stages = len(coefficients) // 5
+    state = [[0, 0, 0, 0] for _ in range(stages)]
+    shift = 31 - post_shift
+    largest = 0
+    out = []
+    for x in samples:
+        for i in range(stages):
+            b0, b1, b2, a1, a2 = coefficients[5 * i:5 * i + 5]
+            s = state[i]
+            acc = b0 * x + b1 * s[0] + b2 * s[1] + a1 * s[2] + a2 * s[3]
+            y = acc >> shift
+            largest = max(largest, abs(y))
+            s[1], s[0], s[3], s[2] = s[0], x, s[2], y
+            x = y
+        out.append(x)
+    return out, largest
+
+
+# Reads the stage count, post shift and coefficients, then filters one sample
+# per line until end of input
+FIRMWARE_HARNESS = r"""
+#include <stdio.h>
+#include "Biquad.h"
+
+int main() {
+    int stages, post_shift;
+    if (scanf("%d %d", &stages, &post_shift) != 2) {
+        return 1;
+    }
+    static int32_t coefficients[5 * Biquad::kMaxStages];
+    for (int i = 0; i < 5 * stages; i++) {
+        long c;
+        if (scanf("%ld", &c) != 1) {
+            return 1;
+        }
+        coefficients[i] = (int32_t)c;
+    }
+    Biquad biquad(coefficients, stages, post_shift);
+    long x;
+    while (scanf("%ld", &x) == 1) {
+        printf("%ld\n", (long)biquad.filter((int32_t)x));
+    }
+    return 0;
+}
+"""
+
+
+class Firmware(object):
+    """Biquad/Biquad.cpp built for the host, run() like the model's."""
+
+    def __init__(self, cxx):
+        root = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+        self.dir = tempfile.mkdtemp(prefix='biquad')
+        with open(os.path.join(self.dir, 'mbed.h'), 'w') as f:
+            f.write('#include <stdint.h>\n')
+        harness = os.path.join(self.dir, 'harness.cpp')
+        with open(harness, 'w') as f:
+            f.write(FIRMWARE_HARNESS)
+        self.exe = os.path.join(self.dir, 'biquad')
+        subprocess.check_call([cxx, '-O2', '-Wall', '-I', self.dir, '-I', os.path.join(root, 'Biquad'),
+                               harness, os.path.join(root, 'Biquad', 'Biquad.cpp'), '-o', self.exe])
+
+    def close(self):
+        shutil.rmtree(self.dir, ignore_errors=True)
+
+    def run(self, coefficients, post_shift, samples):
+        text = '%d %d\n%s\n%s\n' % (len(coefficients) // 5, post_shift,
+                                     ' '.join(str(c) for c in coefficients),
+                                     '\n'.join(str(x) for x in samples))
+        out = subprocess.run([self.exe], input=text.encode(), stdout=subprocess.PIPE, check=True).stdout
+        return [int(y) for y in out.split()]
+
+
+def sine(f, fs):
+    """A sine around mid scale, long enough to settle and then measure over,
+    and the sample it settles by."""
+    amplitude = FULL_SCALE // 4
+    offset = FULL_SCALE // 2
+    settle = int(fs / f * 4) + int(fs * 40)
+    period = fs / f
+    count = int(period * max(4, int(200 / period) + 1))
+    total = settle + count
+    samples = [offset + int(round(amplitude * math.sin(2.0 * math.pi * f * n / fs))) for n in range(total)]
+    return samples, settle
+
+
+def gain(out, settle, f, fs):
+    """Gain at f of the filter's output for sine()."""
+    amplitude = FULL_SCALE // 4
+    tail = out[settle:]
+    mean = sum(tail) / float(len(tail))
+    i = sum((y - mean) * math.sin(2.0 * math.pi * f * (settle + n) / fs) for n, y in enumerate(tail))
+    q = sum((y - mean) * math.cos(2.0 * math.pi * f * (settle + n) / fs) for n, y in enumerate(tail))
+    return 2.0 * math.hypot(i, q) / len(tail) / amplitude
+
+
+def measure(coefficients, post_shift, f, fs):
+    samples, settle = sine(f, fs)
+    out, _ = run(coefficients, post_shift, samples)
+    return gain(out, settle, f, fs)
+
+
+def db(gain):
+    return 20.0 * math.log10(gain) if gain > 0.0 else -999.0
+
+
+def check(name, sections, coefficients, post_shift, fs, fc, firmware=None):
+    ok = True
+    sys.stderr.write('%s: %d stages, post shift %d, cutoff %g Hz at %g Hz\n'
+                     % (name, len(sections), post_shift, fc, fs))
+    sys.stderr.write('  %10s %10s %10s%s\n' % ('Hz', 'design dB', 'fixed dB',
+                                               ' %10s' % 'Biquad dB' if firmware else ''))
+    for ratio in (0.1, 0.25, 0.5, 1.0, 2.0, 4.0, 8.0, 16.0):
+        f = fc * ratio
+        if f >= fs / 2.0:
+            break
+        design = db(response(sections, f, fs))
+        fixed = db(measure(coefficients, post_shift, f, fs))
+        bad = design > CHECK_FLOOR_DB and abs(design - fixed) > GAIN_TOLERANCE_DB
+        built = ''
+        if firmware:
+            samples, settle = sine(f, fs)
+            built_db = db(gain(firmware.run(coefficients, post_shift, samples), settle, f, fs))
+            bad = bad or (design > CHECK_FLOOR_DB and abs(design - built_db) > GAIN_TOLERANCE_DB)
+            built = ' %10.2f' % built_db
+        sys.stderr.write('  %10.3f %10.2f %10.2f%s%s\n' % (f, design, fixed, built, '  <-- off' if bad else ''))
+        ok = ok and not bad
+
+    # DC, and a full scale step both ways must not wrap a stage
+    out, largest = run(coefficients, post_shift, [FULL_SCALE // 2] * int(fs * 60))
+    dc = out[-1] / float(FULL_SCALE // 2)
+    _, up = run(coefficients, post_shift, [0] * 10 + [FULL_SCALE] * int(fs * 60))
+    _, down = run(coefficients, post_shift, [FULL_SCALE] * int(fs * 60) + [0] * int(fs * 60))
+    largest = max(largest, up, down)
+    sys.stderr.write('  DC gain %.5f, largest stage output %.3f of Q31\n' % (dc, largest / float(1 << 31)))
+    if abs(dc - 1.0) > 0.001:
+        sys.stderr.write('  DC gain off\n')
+        ok = False
+    if largest >= (1 << 31):
+        sys.stderr.write('  step overflows Q31, lower INPUT_SHIFT\n')
+        ok = False
+
+    # The built filter must match the model sample for sample on the steps
+    if firmware:
+        for samples in ([0] * 10 + [FULL_SCALE] * int(fs * 60),
+                        [FULL_SCALE] * int(fs * 60) + [0] * int(fs * 60)):
+            model, _ = run(coefficients, post_shift, samples)
+            if firmware.run(coefficients, post_shift, samples) != model:
+                sys.stderr.write('  Biquad.cpp differs from the model on a step\n')
+                ok = False
+                break
+    return ok
+
+
+def parse_filter(text):
+    name, fc, stages = text.split(':')
+    return name, float(fc), int(stages)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('--fs', type=float, default=50.0, help='sample rate, Hz')
+    parser.add_argument('--filter', action='append', type=parse_filter,
+                        help='NAME:CUTOFF_HZ:STAGES, default Thermistor:0.5:2')
+    parser.add_argument('--header', help='C header to write, e.g. thermistor_filter.h')
+    parser.add_argument('--firmware', action='store_true',
+                        help='also build Biquad/Biquad.cpp for the host and check it')
+    parser.add_argument('--cxx', default=os.environ.get('CXX', 'c++'), help='host C++ compiler for --firmware')
+    args = parser.parse_args()
+    filters = args.filter or [('Thermistor', 0.5, 2)]
+    firmware = Firmware(args.cxx) if args.firmware else None
+
+    ok = True
+    out = []
+    out.append('// Biquad low pass coefficients, CMSIS DF1 Q31 layout')
+    out.append('// Generated by tools/biquad_design.py --fs %g %s' % (
+        args.fs, ' '.join('--filter %s:%g:%d' % f for f in filters)))
+    out.append('')
+    out.append('// Rate the filters were designed for, run them at this rate')
+    out.append('const float kFilterRate_Hz = %.1f;' % args.fs)
+    out.append('// Readings are shifted up this far going in and back down coming out')
+    out.append('const int kFilterInputShift = %d;' % INPUT_SHIFT)
+    for name, fc, stages in filters:
+        if stages < 1 or fc <= 0.0 or fc >= args.fs / 2.0:
+            sys.exit('%s: need at least one stage and a cutoff below %g Hz' % (name, args.fs / 2.0))
+        sections = butterworth(args.fs, fc, stages)
+        coefficients, post_shift = quantize(sections)
+        ok = check(name, sections, coefficients, post_shift, args.fs, fc, firmware) and ok
+        out.append('')
+        out.append('// %s, %d pole Butterworth, %g Hz cutoff' % (name, 2 * stages, fc))
+        out.append('const int k%sFilterStages    = %d;' % (name, stages))
+        out.append('const int k%sFilterPostShift = %d;' % (name, post_shift))
+        out.append('const int32_t k%sFilter[] =' % name)
+        rows = []
+        for i in range(stages):
+            rows.append(', '.join('%11d' % c for c in coefficients[5 * i:5 * i + 5]))
+        out.append('   {' + ',\n    '.join(rows) + '};')
+
+    if firmware:
+        firmware.close()
+    if args.header:
+        with open(args.header, 'w') as f:
+            f.write('\n'.join(out) + '\n')
+    if not ok:
+        sys.exit('frequency response check failed')
+
+
+if __name__ == '__main__':
+    main()
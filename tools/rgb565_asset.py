@@ -0,0 +1,161 @@
+#!/usr/bin/env python3
+"""Convert images to RGB565 C headers for uLCD_4DGL::BLIT / BLIT_RLE.
+
+Copyright 2020 Jonathan L. Martin <jon.martini@gmail.com>
+
+MIT license, see LICENSE.
+
+Inputs:
+  *.ppm / *.pnm      binary (P6) or ascii (P3) pixmaps, read natively
+  *.h               legacy 24-bit "const int name[] = {0xRRGGBB, ...}" arrays
+                    with name_w / name_h constants (e.g. buzz.h)
+  anything else     read through Pillow, if it is installed
+
+Output is a header with const uint16_t pixel data, already in the byte order
+the screen expects, plus name_w and name_h. With --rle the data is written as
+(count, color) pairs and BLIT_RLE must be used to draw it.
+
+Example:
+  python3 tools/rgb565_asset.py buzz.h -o buzz.h --name buzz --rle
+"""
+
+import argparse
+import os
+import re
+import sys
+
+
+def rgb565(r, g, b):
+    # Same bit selection the int BLIT used on target
+    return ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3)
+
+
+def _ppm_tokens(data):
+    pos = 0
+    while True:
+        while pos < len(data) and data[pos:pos + 1].isspace():
+            pos += 1
+        if data[pos:pos + 1] == b'#':
+            while pos < len(data) and data[pos:pos + 1] not in (b'\n', b'\r'):
+                pos += 1
+            continue
+        start = pos
+        while pos < len(data) and not data[pos:pos + 1].isspace():
+            pos += 1
+        yield data[start:pos], pos
+
+
+def read_ppm(path):
+    with open(path, 'rb') as f:
+        data = f.read()
+    tokens = _ppm_tokens(data)
+    magic = next(tokens)[0]
+    w = int(next(tokens)[0])
+    h = int(next(tokens)[0])
+    maxval, pos = next(tokens)
+    maxval = int(maxval)
+    if magic == b'P6':
+        if maxval > 255:
+            raise ValueError('16 bit PPM not supported')
+        raw = data[pos + 1:pos + 1 + w * h * 3]
+        values = list(raw)
+    elif magic == b'P3':
+        values = [int(next(tokens)[0]) for _ in range(w * h * 3)]
+    else:
+        raise ValueError('%s: not a P3/P6 pixmap' % path)
+    if maxval != 255:
+        values = [v * 255 // maxval for v in values]
+    pixels = [tuple(values[i:i + 3]) for i in range(0, w * h * 3, 3)]
+    return w, h, pixels
+
+
+def read_header(path):
+    with open(path) as f:
+        text = f.read()
+    text = re.sub(r'//[^\n]*', '', text)
+    array = re.search(r'(\w+)\s*\[\s*\]\s*=\s*\{([^}]*)\}', text)
+    if not array:
+        raise ValueError('%s: no array found' % path)
+    name = array.group(1)
+    w = re.search(r'\b%s_w\s*=\s*(\d+)' % name, text)
+    h = re.search(r'\b%s_h\s*=\s*(\d+)' % name, text)
+    if not w or not h:
+        raise ValueError('%s: missing %s_w / %s_h' % (path, name, name))
+    colors = [int(v, 0) for v in array.group(2).replace(',', ' ').split()]
+    pixels = [((c >> 16) & 0xFF, (c >> 8) & 0xFF, c & 0xFF) for c in colors]
+    return int(w.group(1)), int(h.group(1)), pixels
+
+
+def read_pillow(path):
+    try:
+        from PIL import Image
+    except ImportError:
+        sys.exit('%s: install Pillow or convert to PPM first' % path)
+    image = Image.open(path).convert('RGB')
+    return image.width, image.height, list(image.getdata())
+
+
+def read_image(path):
+    ext = os.path.splitext(path)[1].lower()
+    if ext in ('.ppm', '.pnm'):
+        return read_ppm(path)
+    if ext == '.h':
+        return read_header(path)
+    return read_pillow(path)
+
+
+def rle(words):
+    runs = []
+    for word in words:
+        if runs and runs[-1][1] == word and runs[-1][0] < 0xFFFF:
+            runs[-1][0] += 1
+        else:
+            runs.append([1, word])
+    return [v for run in runs for v in run]
+
+
+def format_words(words, per_line=12):
+    lines = []
+    for i in range(0, len(words), per_line):
+        lines.append(' ' + ', '.join('0x%04X' % v for v in words[i:i + per_line]))
+    return ',\n'.join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('input')
+    parser.add_argument('-o', '--output', help='header to write, default stdout')
+    parser.add_argument('--name', help='C identifier, default input file name')
+    parser.add_argument('--rle', action='store_true', help='write (count, color) runs for BLIT_RLE')
+    args = parser.parse_args()
+
+    name = args.name or re.sub(r'\W', '_', os.path.splitext(os.path.basename(args.input))[0])
+    w, h, pixels = read_image(args.input)
+    if len(pixels) != w * h:
+        sys.exit('%s: expected %d pixels, found %d' % (args.input, w * h, len(pixels)))
+    words = [rgb565(*p) for p in pixels]
+    data = rle(words) if args.rle else words
+
+    out = []
+    out.append('// %s, %d x %d pixels, RGB565%s' % (name, w, h, ' run length encoded' if args.rle else ''))
+    out.append('// Generated by tools/rgb565_asset.py from %s, %d bytes of flash.' % (os.path.basename(args.input), 2 * len(data)))
+    out.append('// Draw with uLCD.%s(x, y, %s_w, %s_h, %s);' % ('BLIT_RLE' if args.rle else 'BLIT', name, name, name))
+    out.append('#include <stdint.h>')
+    out.append('')
+    out.append('const uint16_t %s[] =' % name)
+    out.append(' {' + format_words(data)[1:] + '};')
+    out.append('')
+    out.append('const int %s_w = %d;' % (name, w))
+    out.append('const int %s_h = %d;' % (name, h))
+    text = '\n'.join(out) + '\n'
+
+    if args.output:
+        with open(args.output, 'w') as f:
+            f.write(text)
+    else:
+        sys.stdout.write(text)
+    sys.stderr.write('%s: %d pixels, %d bytes (24-bit int array was %d)\n' % (name, w * h, 2 * len(data), 4 * w * h))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+"""Extract the ride log from an image of the uLCD microSD card as CSV.
+
+Copyright 2020 Jonathan L. Martin <jon.martini@gmail.com>
+
+MIT license, see LICENSE.
+
+Reads the raw sectors SdLogger writes, see SdLogger.h for the layout and
+LogRecord in main.cpp for the record.  Image the card first, e.g.
+
+  sudo dd if=/dev/sdX of=card.img bs=512 skip=65536 count=262145
+  python3 tools/sd_log_extract.py card.img --base 0 > ride.csv
+
+or point it at the device itself.  --base is the header sector relative to
+the start of the image (kLogBaseSector when the whole card is imaged).
+"""
+
+import argparse
+import struct
+import sys
+
+SECTOR_SIZE = 512
+SECTOR_HEADER = struct.Struct('<IHBB')
+HEADER = struct.Struct('<8sHHIIII')
+MAGIC = b'PCCLOG01'
+MARKER = 0xA5
+
+# LogRecord in main.cpp
+RECORD = struct.Struct('<IhhhBBBBHHBB')
+USER_STATES = ['Off', 'Cool', 'Heat', 'RunRadiatorPump', 'RunShirtPump']
+SYSTEM_STATES = ['Off', 'Precool', 'Preheat', 'Cooling', 'Heating', 'CoolDown', 'CoolCoast',
+                 'HeatUp', 'HeatCoast', 'RunRadiatorPump', 'RunShirtPump']
+CLIMATE_STATES = ['Heating', 'Cooling']
+COLUMNS = ['boot', 'sequence', 'time_s', 'user_C', 'shirt_C', 'radiator_C', 'user_state',
+           'system_state', 'climate', 'tec_percent', 'radiator_flow_ml', 'shirt_flow_ml',
+           'fan_percent', 'bleeding', 'fans_stalled', 'sensor_fault']
+
+
+def name(names, index):
+    return names[index] if index < len(names) else str(index)
+
+
+def read_sector(image, sector):
+    image.seek(sector * SECTOR_SIZE)
+    data = image.read(SECTOR_SIZE)
+    return data if len(data) == SECTOR_SIZE else None
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('image', help='raw card image or block device')
+    parser.add_argument('--base', type=lambda v: int(v, 0), default=0x10000,
+                        help='header sector in the image, default kLogBaseSector')
+    args = parser.parse_args()
+
+    with open(args.image, 'rb') as image:
+        header = read_sector(image, args.base)
+        if header is None:
+            sys.exit('%s: no sector %d' % (args.image, args.base))
+        magic, version, record_size, _, num_sectors, next_sequence, boots = HEADER.unpack_from(header)
+        if magic != MAGIC:
+            sys.exit('%s: no log header at sector %d' % (args.image, args.base))
+        if record_size != RECORD.size:
+            sys.exit('record size %d, this tool reads %d' % (record_size, RECORD.size))
+        sys.stderr.write('log version %d, %d data sectors, checkpoint %d, %d boots\n'
+                         % (version, num_sectors, next_sequence, boots))
+
+        # Collect every valid data sector, then put them back in sequence order.
+        # Sectors from an earlier lap of the ring are overwritten in place, so
+        # whatever is on the card is the newest copy.
+        sectors = []
+        for i in range(num_sectors):
+            data = read_sector(image, args.base + 1 + i)
+            if data is None:
+                break
+            sequence, boot, count, marker = SECTOR_HEADER.unpack_from(data)
+            if marker != MARKER or sequence == 0 or sequence % num_sectors != i:
+                continue
+            sectors.append((sequence, boot, count, data))
+        sectors.sort()
+
+    out = sys.stdout
+    out.write(','.join(COLUMNS) + '\n')
+    records = 0
+    for sequence, boot, count, data in sectors:
+        for r in range(count):
+            (time_s, user, shirt, radiator, user_state, system_state, climate, tec,
+             radiator_flow, shirt_flow, fan, flags) = RECORD.unpack_from(
+                 data, SECTOR_HEADER.size + r * RECORD.size)
+            out.write('%d,%d,%d,%.2f,%.2f,%.2f,%s,%s,%s,%d,%d,%d,%d,%d,%d,%d\n' % (
+                boot, sequence, time_s, user / 100.0, shirt / 100.0, radiator / 100.0,
+                name(USER_STATES, user_state), name(SYSTEM_STATES, system_state),
+                name(CLIMATE_STATES, climate), tec, radiator_flow, shirt_flow, fan,
+                flags & 1, (flags >> 1) & 1, (flags >> 2) & 1))
+            records += 1
+    sys.stderr.write('%d sectors, %d records\n' % (len(sectors), records))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+"""Build the flash lookup table for a FixedThermistor.
+
+Copyright 2020 Jonathan L. Martin <jon.martini@gmail.com>
+
+MIT license, see LICENSE.
+
+Evaluates the Steinhart-Hart equation at every table step of read_u16() the
+same way the Thermistor constructor does, so FixedThermistor<Params> reads
+exactly what a Thermistor with the same coefficients reads, and writes the
+table and its Params struct as a header:
+
+  python3 tools/thermistor_table.py --name Ntc3950 --r1 100000 \\
+      --a 0.6172273387e-3 --b 2.287682172e-4 --c 0.6749479638e-7 \\
+      --header thermistor_table.h
+
+Keep --steps, TABLE_MIN_CC and TABLE_MAX_CC in step with Thermistor.h.
+"""
+
+import argparse
+import math
+import sys
+
+TABLE_MIN_CC = -5500
+TABLE_MAX_CC = 15000
+
+
+def temp_from_c(celsius):
+    """temp_from_C() in Temperature.cpp, half away from zero then truncated."""
+    return int(celsius * 100.0 + (-0.5 if celsius < 0 else 0.5))
+
+
+def table(r1, a, b, c, steps):
+    step = 65536 // steps
+    out = []
+    for i in range(steps + 1):
+        raw = float(i * step)
+        t_c = TABLE_MAX_CC / 100.0 if i == 0 else TABLE_MIN_CC / 100.0
+        if 0 < raw < 65536.0:
+            ln_r2 = math.log(r1 * raw / (65536.0 - raw))
+            t_c = (1.0 / (a + (b * ln_r2) + (c * math.pow(ln_r2, 3.0)))) - 273.15
+        out.append(max(TABLE_MIN_CC, min(TABLE_MAX_CC, temp_from_c(t_c))))
+    return out
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('--name', default='Ntc3950', help='Params struct name')
+    parser.add_argument('--r1', type=float, default=100000.0, help='pull up, Ohms')
+    parser.add_argument('--a', type=float, default=0.6172273387e-3, help='Steinhart-Hart A')
+    parser.add_argument('--b', type=float, default=2.287682172e-4, help='Steinhart-Hart B')
+    parser.add_argument('--c', type=float, default=0.6749479638e-7, help='Steinhart-Hart C')
+    parser.add_argument('--steps', type=int, default=128, help='table steps, a power of 2')
+    parser.add_argument('--header', help='C header to write, e.g. thermistor_table.h')
+    args = parser.parse_args()
+    if args.steps < 2 or args.steps & (args.steps - 1) or args.steps > 65536:
+        sys.exit('--steps must be a power of 2')
+
+    values = table(args.r1, args.a, args.b, args.c, args.steps)
+    shift = 16 - int(math.log2(args.steps))
+    sys.stderr.write('%s: %d points, %g C to %g C\n'
+                     % (args.name, len(values), values[-1] / 100.0, values[0] / 100.0))
+
+    out = []
+    out.append('// Thermistor lookup table in flash, for FixedThermistor<%s>' % args.name)
+    out.append('// Generated by tools/thermistor_table.py --name %s --r1 %r --a %r --b %r --c %r --steps %d'
+               % (args.name, args.r1, args.a, args.b, args.c, args.steps))
+    out.append('')
+    out.append('// Hundredths of a degree C at read_u16() = i << kTableShift')
+    out.append('const temp_cC k%sTable[%d] =' % (args.name, len(values)))
+    rows = [', '.join('%6d' % v for v in values[i:i + 8]) for i in range(0, len(values), 8)]
+    out.append('   {' + ',\n    '.join(rows) + '};')
+    out.append('')
+    out.append('struct %s' % args.name)
+    out.append('{')
+    out.append('    enum { kTableShift = %d };' % shift)
+    out.append('    static const temp_cC *table() { return k%sTable; }' % args.name)
+    out.append('};')
+    if args.header:
+        with open(args.header, 'w') as f:
+            f.write('\n'.join(out) + '\n')
+    else:
+        sys.stdout.write('\n'.join(out) + '\n')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,152 @@
+#!/usr/bin/env python3
+"""Build the uLCD microSD image of pre-rendered UI labels and digits.
+
+Copyright 2020 Jonathan L. Martin <jon.martini@gmail.com>
+
+MIT license, see LICENSE.
+
+Renders the static labels, the state names and large setpoint digits into
+Goldelox images (width, height as big endian words, 0x10, 0x00, then RGB565
+pixels), each starting on a sector, behind a directory sector that SdImages
+checks at start up.  Writes the card image and the ui_assets.h header the
+firmware builds against:
+
+  python3 tools/ui_assets.py -o ui_assets.img --header ui_assets.h
+  sudo dd if=ui_assets.img of=/dev/sdX bs=512 seek=32768
+
+Directory sector, big endian: "PCCUI001", image count (word), 0 (word),
+build id (two words), then per image its sector offset from the directory
+(two words), width and height (words).  The build id is a CRC of the images,
+so a card from a different build is ignored and the firmware prints text.
+
+Keep the state lists in the same order as the enums in main.cpp.
+"""
+
+import argparse
+import os
+import struct
+import sys
+import zlib
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from ulcd_emu import FONT_5X7  # noqa: E402
+
+SECTOR_SIZE = 512
+MAGIC = b'PCCUI001'
+BASE_SECTOR = 0x8000
+
+WHITE = 0xFFFF
+BLACK = 0x0000
+
+# Left hand labels, one per text row from row 1, see DisplayInit() in main.cpp
+LABELS = ['Req:', 'Sys:', 'User:', '', 'Shirt:', 'Rad:', 'Rad Flow:', 'Shirt Flow:']
+
+# user_state and system_state in main.cpp, padded like UserStateToStr()
+USER_STATES = [('Off', 'Off'), ('Cool', 'Cooling'), ('Heat', 'Heating'),
+               ('RunRadiatorPump', 'Rad Pump'), ('RunShirtPump', 'Shirt Pump')]
+SYSTEM_STATES = [('Off', 'Off'), ('Precool', 'Precool'), ('Preheat', 'Preheat'),
+                 ('Cooling', 'Run Cool'), ('Heating', 'Run Heat'), ('CoolDown', 'Cool Down'),
+                 ('CoolCoast', 'Cool Coast'), ('HeatUp', 'Heat Up'), ('HeatCoast', 'Heat Coast'),
+                 ('RunRadiatorPump', 'Rad Pump'), ('RunShirtPump', 'Shirt Pump')]
+USER_WIDTH = 10    # characters, as UserStateToStr() pads
+SYSTEM_WIDTH = 11  # as SystemStateToStr() pads
+
+# Setpoint digits at twice the system font size
+DIGITS = [('Digit%d' % d, str(d)) for d in range(10)] + \
+         [('DigitPoint', '.'), ('DigitBlank', ' '), ('DigitMinus', '-'), ('DegreesC', 'oC')]
+DIGIT_SCALE = 2
+
+
+def render(text, columns=None, scale=1, fg=WHITE, bg=BLACK):
+    """Text in 7 x 8 cells like the Goldelox system font, as RGB565 rows."""
+    columns = columns if columns is not None else len(text)
+    text = text.ljust(columns)
+    width = 7 * columns * scale
+    height = 8 * scale
+    pixels = [bg] * (width * height)
+    for n, ch in enumerate(text):
+        index = ord(ch) - 0x20
+        glyph = FONT_5X7[index * 5:index * 5 + 5] if 0 <= index < 95 else bytes(5)
+        for gx in range(5):
+            for gy in range(7):
+                if (glyph[gx] >> gy) & 1:
+                    for my in range(scale):
+                        for mx in range(scale):
+                            x = (n * 7 + gx) * scale + mx
+                            y = gy * scale + my
+                            pixels[y * width + x] = fg
+    return width, height, pixels
+
+
+def stack(images):
+    """Join images top to bottom, left aligned."""
+    width = max(w for w, _, _ in images)
+    pixels = []
+    for w, h, p in images:
+        for y in range(h):
+            pixels += p[y * w:(y + 1) * w] + [BLACK] * (width - w)
+    return width, sum(h for _, h, _ in images), pixels
+
+
+def goldelox(width, height, pixels):
+    data = struct.pack('>HHBB', width, height, 0x10, 0x00)
+    data += b''.join(struct.pack('>H', p) for p in pixels)
+    return data
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('-o', '--output', default='ui_assets.img', help='card image to write')
+    parser.add_argument('--header', help='C header to write, e.g. ui_assets.h')
+    parser.add_argument('--base', type=lambda v: int(v, 0), default=BASE_SECTOR,
+                        help='card sector the image is written to')
+    args = parser.parse_args()
+
+    assets = [('Labels', stack([render(label, 11) for label in LABELS]))]
+    assets += [('User' + n, render(t, USER_WIDTH)) for n, t in USER_STATES]
+    assets += [('System' + n, render(t, SYSTEM_WIDTH)) for n, t in SYSTEM_STATES]
+    assets += [(n, render(t, scale=DIGIT_SCALE)) for n, t in DIGITS]
+    if len(assets) > (SECTOR_SIZE - 16) // 8:
+        sys.exit('too many assets for one directory sector')
+
+    blobs = [goldelox(*image) for _, image in assets]
+    build_id = 0
+    for blob in blobs:
+        build_id = zlib.crc32(blob, build_id)
+    build_id &= 0xFFFFFFFF
+
+    directory = bytearray(MAGIC + struct.pack('>HHI', len(assets), 0, build_id))
+    body = bytearray()
+    for (name, (w, h, _)), blob in zip(assets, blobs):
+        directory += struct.pack('>IHH', 1 + len(body) // SECTOR_SIZE, w, h)
+        body += blob
+        body += b'\x00' * (-len(body) % SECTOR_SIZE)
+    directory += b'\x00' * (SECTOR_SIZE - len(directory))
+
+    with open(args.output, 'wb') as f:
+        f.write(directory + body)
+    sys.stderr.write('%s: %d images, %d sectors, build id 0x%08X\n'
+                     % (args.output, len(assets), 1 + len(body) // SECTOR_SIZE, build_id))
+
+    if args.header:
+        out = []
+        out.append('// UI images on the uLCD microSD card, drawn with SdImages')
+        out.append('// Generated by tools/ui_assets.py, write %s to the card with' % os.path.basename(args.output))
+        out.append('//   sudo dd if=%s of=/dev/sdX bs=512 seek=%d' % (os.path.basename(args.output), args.base))
+        out.append('')
+        out.append('const uint32_t kUiAssetSector  = 0x%X;' % args.base)
+        out.append('const uint32_t kUiAssetBuildId = 0x%08X;' % build_id)
+        out.append('')
+        out.append('enum ui_asset')
+        names = ['kUi' + name for name, _ in assets] + ['kUiAssetCount']
+        out.append('   {' + ',\n    '.join(names) + '};')
+        out.append('')
+        out.append('// Setpoint digit size in pixels')
+        out.append('const int kUiDigitWidth  = %d;' % (7 * DIGIT_SCALE))
+        out.append('const int kUiDigitHeight = %d;' % (8 * DIGIT_SCALE))
+        with open(args.header, 'w') as f:
+            f.write('\n'.join(out) + '\n')
+
+
+if __name__ == '__main__':
+    main()
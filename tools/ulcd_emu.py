@@ -0,0 +1,530 @@
+#!/usr/bin/env python3
+"""Host emulator for the 4DGL serial commands sent by uLCD_4DGL.
+
+Copyright 2020 Jonathan L. Martin <jon.martini@gmail.com>
+
+MIT license, see LICENSE.
+
+Replays a capture of the bytes the mbed sends to the uLCD-144-G2 (pin p13)
+into a 128 x 128 framebuffer, generates the ACKs and replies the screen would
+send back, and writes each frame as a PNG or PPM with its byte and command
+counts.  Display changes can then be compared and costed without the screen.
+
+Frames are either one capture file each (state carries over from file to
+file), or one capture split in front of every occurrence of a command:
+
+  python3 tools/ulcd_emu.py boot.bin tick1.bin tick2.bin -o frames/
+  python3 tools/ulcd_emu.py run.bin --split-on locate -o frames/ --ppm
+
+Captures must be at one baud rate; a BAUDRATE command in the capture only
+changes the wire time estimate.  Text uses a 5x7 glyph in the font's cell,
+close to but not pixel exact with the Goldelox system font.  An SD card is
+emulated in memory, optionally loaded from a raw card image with --sd, and
+display_image expects a 6 byte header: width, height (big endian words),
+0x10 (16 bit colour), 0x00, then RGB565 pixels.
+"""
+
+import argparse
+import collections
+import os
+import struct
+import sys
+import zlib
+
+WIDTH = 128
+HEIGHT = 128
+
+ACK = b'\x06'
+NAK = b'\x15'
+
+SECTOR_SIZE = 512
+
+# 5x7 glyphs for 0x20-0x7E, one byte per column, bit 0 at the top
+FONT_5X7 = bytes([
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x5F, 0x00, 0x00,
+    0x00, 0x07, 0x00, 0x07, 0x00, 0x14, 0x7F, 0x14, 0x7F, 0x14,
+    0x24, 0x2A, 0x7F, 0x2A, 0x12, 0x23, 0x13, 0x08, 0x64, 0x62,
+    0x36, 0x49, 0x55, 0x22, 0x50, 0x00, 0x05, 0x03, 0x00, 0x00,
+    0x00, 0x1C, 0x22, 0x41, 0x00, 0x00, 0x41, 0x22, 0x1C, 0x00,
+    0x08, 0x2A, 0x1C, 0x2A, 0x08, 0x08, 0x08, 0x3E, 0x08, 0x08,
+    0x00, 0x50, 0x30, 0x00, 0x00, 0x08, 0x08, 0x08, 0x08, 0x08,
+    0x00, 0x60, 0x60, 0x00, 0x00, 0x20, 0x10, 0x08, 0x04, 0x02,
+    0x3E, 0x51, 0x49, 0x45, 0x3E, 0x00, 0x42, 0x7F, 0x40, 0x00,
+    0x42, 0x61, 0x51, 0x49, 0x46, 0x21, 0x41, 0x45, 0x4B, 0x31,
+    0x18, 0x14, 0x12, 0x7F, 0x10, 0x27, 0x45, 0x45, 0x45, 0x39,
+    0x3C, 0x4A, 0x49, 0x49, 0x30, 0x01, 0x71, 0x09, 0x05, 0x03,
+    0x36, 0x49, 0x49, 0x49, 0x36, 0x06, 0x49, 0x49, 0x29, 0x1E,
+    0x00, 0x36, 0x36, 0x00, 0x00, 0x00, 0x56, 0x36, 0x00, 0x00,
+    0x00, 0x08, 0x14, 0x22, 0x41, 0x14, 0x14, 0x14, 0x14, 0x14,
+    0x41, 0x22, 0x14, 0x08, 0x00, 0x02, 0x01, 0x51, 0x09, 0x06,
+    0x32, 0x49, 0x79, 0x41, 0x3E, 0x7E, 0x11, 0x11, 0x11, 0x7E,
+    0x7F, 0x49, 0x49, 0x49, 0x36, 0x3E, 0x41, 0x41, 0x41, 0x22,
+    0x7F, 0x41, 0x41, 0x22, 0x1C, 0x7F, 0x49, 0x49, 0x49, 0x41,
+    0x7F, 0x09, 0x09, 0x01, 0x01, 0x3E, 0x41, 0x41, 0x51, 0x32,
+    0x7F, 0x08, 0x08, 0x08, 0x7F, 0x00, 0x41, 0x7F, 0x41, 0x00,
+    0x20, 0x40, 0x41, 0x3F, 0x01, 0x7F, 0x08, 0x14, 0x22, 0x41,
+    0x7F, 0x40, 0x40, 0x40, 0x40, 0x7F, 0x02, 0x04, 0x02, 0x7F,
+    0x7F, 0x04, 0x08, 0x10, 0x7F, 0x3E, 0x41, 0x41, 0x41, 0x3E,
+    0x7F, 0x09, 0x09, 0x09, 0x06, 0x3E, 0x41, 0x51, 0x21, 0x5E,
+    0x7F, 0x09, 0x19, 0x29, 0x46, 0x46, 0x49, 0x49, 0x49, 0x31,
+    0x01, 0x01, 0x7F, 0x01, 0x01, 0x3F, 0x40, 0x40, 0x40, 0x3F,
+    0x1F, 0x20, 0x40, 0x20, 0x1F, 0x7F, 0x20, 0x18, 0x20, 0x7F,
+    0x63, 0x14, 0x08, 0x14, 0x63, 0x03, 0x04, 0x78, 0x04, 0x03,
+    0x61, 0x51, 0x49, 0x45, 0x43, 0x00, 0x00, 0x7F, 0x41, 0x41,
+    0x02, 0x04, 0x08, 0x10, 0x20, 0x41, 0x41, 0x7F, 0x00, 0x00,
+    0x04, 0x02, 0x01, 0x02, 0x04, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x00, 0x01, 0x02, 0x04, 0x00, 0x20, 0x54, 0x54, 0x54, 0x78,
+    0x7F, 0x48, 0x44, 0x44, 0x38, 0x38, 0x44, 0x44, 0x44, 0x20,
+    0x38, 0x44, 0x44, 0x48, 0x7F, 0x38, 0x54, 0x54, 0x54, 0x18,
+    0x08, 0x7E, 0x09, 0x01, 0x02, 0x08, 0x14, 0x54, 0x54, 0x3C,
+    0x7F, 0x08, 0x04, 0x04, 0x78, 0x00, 0x44, 0x7D, 0x40, 0x00,
+    0x20, 0x40, 0x44, 0x3D, 0x00, 0x00, 0x7F, 0x10, 0x28, 0x44,
+    0x00, 0x41, 0x7F, 0x40, 0x00, 0x7C, 0x04, 0x18, 0x04, 0x78,
+    0x7C, 0x08, 0x04, 0x04, 0x78, 0x38, 0x44, 0x44, 0x44, 0x38,
+    0x7C, 0x14, 0x14, 0x14, 0x08, 0x08, 0x14, 0x14, 0x18, 0x7C,
+    0x7C, 0x08, 0x04, 0x04, 0x08, 0x48, 0x54, 0x54, 0x54, 0x20,
+    0x04, 0x3F, 0x44, 0x40, 0x20, 0x3C, 0x40, 0x40, 0x20, 0x7C,
+    0x1C, 0x20, 0x40, 0x20, 0x1C, 0x3C, 0x40, 0x30, 0x40, 0x3C,
+    0x44, 0x28, 0x10, 0x28, 0x44, 0x0C, 0x50, 0x50, 0x50, 0x3C,
+    0x44, 0x64, 0x54, 0x4C, 0x44, 0x00, 0x08, 0x36, 0x41, 0x00,
+    0x00, 0x00, 0x7F, 0x00, 0x00, 0x00, 0x41, 0x36, 0x08, 0x00,
+    0x08, 0x08, 0x2A, 0x1C, 0x08,
+])
+
+# Character cell for each set_font() value, as uLCD_4DGL sizes them
+FONT_CELLS = {0x00: (7, 8), 0x01: (8, 8), 0x02: (8, 12), 0x03: (12, 16), 0x04: (6, 8)}
+
+# 0xFF prefixed commands: name, argument bytes, extra reply bytes after the ACK
+FF_COMMANDS = {
+    0xD7: ('cls', 0, 0),
+    0x6E: ('background_color', 2, 2),
+    0x7E: ('textbackground_color', 2, 2),
+    0x7F: ('color', 2, 2),
+    0x68: ('display_control', 2, 0),
+    0x66: ('display_power', 2, 0),
+    0xCD: ('circle', 8, 0),
+    0xCC: ('filled_circle', 8, 0),
+    0xC9: ('triangle', 14, 0),
+    0xD2: ('line', 10, 0),
+    0xCF: ('rectangle', 10, 0),
+    0xCE: ('filled_rectangle', 10, 0),
+    0xCB: ('pixel', 6, 0),
+    0xCA: ('read_pixel', 4, 2),
+    0xD8: ('pen_size', 1, 2),
+    0x7D: ('set_font', 2, 2),
+    0x77: ('text_mode', 2, 2),
+    0x76: ('text_bold', 2, 2),
+    0x75: ('text_italic', 2, 2),
+    0x74: ('text_inverse', 2, 2),
+    0x73: ('text_underline', 2, 2),
+    0x7C: ('text_width', 2, 2),
+    0x7B: ('text_height', 2, 2),
+    0xE4: ('locate', 4, 0),
+    0xFE: ('putc', 2, 0),
+    0xB1: ('media_init', 0, 2),
+    0xB9: ('set_byte_address', 4, 0),
+    0xB8: ('set_sector_address', 4, 0),
+    0xB7: ('read_byte', 0, 2),
+    0xB6: ('read_word', 0, 2),
+    0xB5: ('write_byte', 2, 2),
+    0xB4: ('write_word', 2, 2),
+    0xB2: ('flush_media', 0, 2),
+    0xB3: ('display_image', 4, 0),
+    0xBB: ('display_video', 4, 0),
+    0xBA: ('display_frame', 6, 0),
+}
+
+
+def rgb565_to_rgb(c):
+    r = (c >> 11) & 0x1F
+    g = (c >> 5) & 0x3F
+    b = c & 0x1F
+    return ((r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2))
+
+
+def word(data, i):
+    return (data[i] << 8) | data[i + 1]
+
+
+def signed(w):
+    return w - 0x10000 if w & 0x8000 else w
+
+
+class Screen(object):
+    def __init__(self, sd=None):
+        self.pixels = [0] * (WIDTH * HEIGHT)
+        self.background = 0x0000
+        self.text_fg = 0xFFFF
+        self.text_bg = 0x0000
+        self.opaque = True
+        self.font = 0x00
+        self.width_mult = 1
+        self.height_mult = 1
+        self.col = 0
+        self.row = 0
+        self.x = 0
+        self.y = 0
+        self.baud = 9600
+        self.sd = sd if sd is not None else bytearray()
+        self.sd_address = 0
+
+    # Drawing
+
+    def plot(self, x, y, c):
+        if 0 <= x < WIDTH and 0 <= y < HEIGHT:
+            self.pixels[y * WIDTH + x] = c
+
+    def hline(self, x1, x2, y, c):
+        if x1 > x2:
+            x1, x2 = x2, x1
+        for x in range(x1, x2 + 1):
+            self.plot(x, y, c)
+
+    def line(self, x1, y1, x2, y2, c):
+        dx = abs(x2 - x1)
+        dy = -abs(y2 - y1)
+        sx = 1 if x1 < x2 else -1
+        sy = 1 if y1 < y2 else -1
+        err = dx + dy
+        while True:
+            self.plot(x1, y1, c)
+            if x1 == x2 and y1 == y2:
+                return
+            e2 = 2 * err
+            if e2 >= dy:
+                err += dy
+                x1 += sx
+            if e2 <= dx:
+                err += dx
+                y1 += sy
+
+    def rectangle(self, x1, y1, x2, y2, c, filled):
+        if filled:
+            for y in range(min(y1, y2), max(y1, y2) + 1):
+                self.hline(x1, x2, y, c)
+        else:
+            self.line(x1, y1, x2, y1, c)
+            self.line(x2, y1, x2, y2, c)
+            self.line(x2, y2, x1, y2, c)
+            self.line(x1, y2, x1, y1, c)
+
+    def circle(self, cx, cy, r, c, filled):
+        x, y, err = r, 0, 1 - r
+        while x >= y:
+            if filled:
+                self.hline(cx - x, cx + x, cy + y, c)
+                self.hline(cx - x, cx + x, cy - y, c)
+                self.hline(cx - y, cx + y, cy + x, c)
+                self.hline(cx - y, cx + y, cy - x, c)
+            else:
+                for px, py in ((x, y), (y, x), (-y, x), (-x, y),
+                               (-x, -y), (-y, -x), (y, -x), (x, -y)):
+                    self.plot(cx + px, cy + py, c)
+            y += 1
+            if err < 0:
+                err += 2 * y + 1
+            else:
+                x -= 1
+                err += 2 * (y - x) + 1
+
+    def glyph(self, ch):
+        fx, fy = FONT_CELLS.get(self.font, (8, 8))
+        cell_w = fx * self.width_mult
+        cell_h = fy * self.height_mult
+        index = ch - 0x20
+        columns = FONT_5X7[index * 5:index * 5 + 5] if 0 <= index < 95 else bytes(5)
+        for gy in range(fy):
+            for gx in range(fx):
+                on = gx < 5 and gy < 7 and (columns[gx] >> gy) & 1
+                if not on and not self.opaque:
+                    continue
+                c = self.text_fg if on else self.text_bg
+                for my in range(self.height_mult):
+                    for mx in range(self.width_mult):
+                        self.plot(self.x + gx * self.width_mult + mx,
+                                  self.y + gy * self.height_mult + my, c)
+        self.x += cell_w
+        if self.x + cell_w > WIDTH:
+            self.x = 0
+            self.y += cell_h
+
+    def move_cursor(self, row, col):
+        fx, fy = FONT_CELLS.get(self.font, (8, 8))
+        self.row, self.col = row, col
+        self.x = col * fx * self.width_mult
+        self.y = row * fy * self.height_mult
+
+    def blit(self, x, y, w, h, data):
+        for i in range(w * h):
+            self.plot(x + i % w, y + i // w, word(data, 2 * i))
+
+    def display_image(self, x, y):
+        a = self.sd_address
+        if a + 6 > len(self.sd):
+            return False
+        w, h = word(self.sd, a), word(self.sd, a + 2)
+        if self.sd[a + 4] != 0x10 or a + 6 + 2 * w * h > len(self.sd):
+            return False
+        self.blit(x, y, w, h, self.sd[a + 6:a + 6 + 2 * w * h])
+        return True
+
+    # Output
+
+    def rgb_rows(self):
+        for y in range(HEIGHT):
+            row = bytearray()
+            for x in range(WIDTH):
+                row.extend(rgb565_to_rgb(self.pixels[y * WIDTH + x]))
+            yield bytes(row)
+
+    def write_ppm(self, path):
+        with open(path, 'wb') as f:
+            f.write(b'P6\n%d %d\n255\n' % (WIDTH, HEIGHT))
+            for row in self.rgb_rows():
+                f.write(row)
+
+    def write_png(self, path):
+        def chunk(kind, data):
+            body = kind + data
+            return struct.pack('>I', len(data)) + body + struct.pack('>I', zlib.crc32(body) & 0xFFFFFFFF)
+        raw = b''.join(b'\x00' + row for row in self.rgb_rows())
+        with open(path, 'wb') as f:
+            f.write(b'\x89PNG\r\n\x1a\n')
+            f.write(chunk(b'IHDR', struct.pack('>IIBBBBB', WIDTH, HEIGHT, 8, 2, 0, 0, 0)))
+            f.write(chunk(b'IDAT', zlib.compress(raw, 9)))
+            f.write(chunk(b'IEND', b''))
+
+
+class Emulator(object):
+    """Parses the byte stream a command at a time and keeps per frame counts."""
+
+    def __init__(self, screen):
+        self.screen = screen
+        self.replies = bytearray()
+        self.new_frame()
+
+    def new_frame(self):
+        self.frame_bytes = 0
+        self.frame_commands = collections.Counter()
+        self.frame_seconds = 0.0
+
+    def commands(self, data):
+        """Yield (name, start, end) for each complete command in data."""
+        i = 0
+        while i < len(data):
+            prefix = data[i]
+            if prefix == 0xFF and i + 1 < len(data):
+                op = data[i + 1]
+                if op not in FF_COMMANDS:
+                    raise ValueError('unknown command 0xFF%02X at byte %d' % (op, i))
+                name, args, _ = FF_COMMANDS[op]
+                end = i + 2 + args
+            elif prefix == 0x00 and i + 1 < len(data):
+                op = data[i + 1]
+                if op == 0x06:
+                    name = 'puts'
+                    end = data.index(b'\x00', i + 2) + 1
+                elif op == 0x0B:
+                    name, end = 'baudrate', i + 4
+                elif op == 0x08:
+                    name, end = 'version', i + 2
+                elif op == 0x0A:
+                    name = 'BLIT'
+                    end = i + 10 + 2 * word(data, i + 6) * word(data, i + 8)
+                elif op == 0x16:
+                    name, end = 'read_sector', i + 2
+                elif op == 0x17:
+                    name, end = 'write_sector', i + 2 + SECTOR_SIZE
+                else:
+                    raise ValueError('unknown command 0x00%02X at byte %d' % (op, i))
+            else:
+                raise ValueError('stray byte 0x%02X at byte %d' % (prefix, i))
+            if end > len(data):
+                raise ValueError('%s truncated at byte %d' % (name, i))
+            yield name, i, end
+            i = end
+
+    def run(self, name, cmd):
+        s = self.screen
+        a = cmd[2:]
+        reply = bytearray(ACK)
+        if name == 'cls':
+            s.pixels = [s.background] * (WIDTH * HEIGHT)
+            s.move_cursor(0, 0)
+        elif name == 'background_color':
+            reply += struct.pack('>H', s.background)
+            s.background = word(a, 0)
+        elif name == 'textbackground_color':
+            reply += struct.pack('>H', s.text_bg)
+            s.text_bg = word(a, 0)
+        elif name == 'color':
+            reply += struct.pack('>H', s.text_fg)
+            s.text_fg = word(a, 0)
+        elif name in ('line', 'rectangle', 'filled_rectangle'):
+            x1, y1, x2, y2 = [signed(word(a, k)) for k in (0, 2, 4, 6)]
+            c = word(a, 8)
+            if name == 'line':
+                s.line(x1, y1, x2, y2, c)
+            else:
+                s.rectangle(x1, y1, x2, y2, c, name == 'filled_rectangle')
+        elif name in ('circle', 'filled_circle'):
+            x, y, r = [signed(word(a, k)) for k in (0, 2, 4)]
+            s.circle(x, y, r, word(a, 6), name == 'filled_circle')
+        elif name == 'triangle':
+            p = [signed(word(a, k)) for k in range(0, 12, 2)]
+            c = word(a, 12)
+            s.line(p[0], p[1], p[2], p[3], c)
+            s.line(p[2], p[3], p[4], p[5], c)
+            s.line(p[4], p[5], p[0], p[1], c)
+        elif name == 'pixel':
+            s.plot(signed(word(a, 0)), signed(word(a, 2)), word(a, 4))
+        elif name == 'read_pixel':
+            x, y = signed(word(a, 0)), signed(word(a, 2))
+            on = 0 <= x < WIDTH and 0 <= y < HEIGHT
+            reply += struct.pack('>H', s.pixels[y * WIDTH + x] if on else 0)
+        elif name == 'set_font':
+            reply += struct.pack('>H', s.font)
+            s.font = a[1]
+        elif name == 'text_mode':
+            reply += struct.pack('>H', int(s.opaque))
+            s.opaque = bool(a[1])
+        elif name == 'text_width':
+            reply += struct.pack('>H', s.width_mult)
+            s.width_mult = max(1, a[1])
+        elif name == 'text_height':
+            reply += struct.pack('>H', s.height_mult)
+            s.height_mult = max(1, a[1])
+        elif name in ('pen_size', 'text_bold', 'text_italic', 'text_inverse', 'text_underline'):
+            reply += b'\x00\x00'
+        elif name == 'locate':
+            s.move_cursor(word(a, 0), word(a, 2))
+        elif name == 'putc':
+            s.glyph(a[1])
+        elif name == 'puts':
+            text = cmd[2:-1]
+            for ch in text:
+                s.glyph(ch)
+            reply += struct.pack('>H', len(text))
+        elif name == 'baudrate':
+            s.baud = 3000000 // (word(a, 0) + 1)
+        elif name == 'version':
+            reply = bytearray(b'\x00\x00')
+        elif name == 'BLIT':
+            s.blit(signed(word(a, 0)), signed(word(a, 2)), word(a, 4), word(a, 6), a[8:])
+        elif name == 'media_init':
+            reply += struct.pack('>H', 1 if s.sd else 0)
+        elif name in ('set_byte_address', 'set_sector_address'):
+            address = (word(a, 0) << 16) | word(a, 2)
+            s.sd_address = address * 512 if name == 'set_sector_address' else address
+        elif name in ('read_byte', 'read_word'):
+            size = 1 if name == 'read_byte' else 2
+            value = 0
+            for k in range(size):
+                value = (value << 8) | (s.sd[s.sd_address] if s.sd_address < len(s.sd) else 0xFF)
+                s.sd_address += 1
+            reply += struct.pack('>H', value)
+        elif name in ('write_byte', 'write_word'):
+            data = a[1:2] if name == 'write_byte' else a[0:2]
+            end = s.sd_address + len(data)
+            if end > len(s.sd):
+                s.sd.extend(b'\xFF' * (end - len(s.sd)))
+            s.sd[s.sd_address:end] = data
+            s.sd_address = end
+            reply += b'\x00\x01'
+        elif name in ('read_sector', 'write_sector'):
+            end = s.sd_address + SECTOR_SIZE
+            if end > len(s.sd):
+                s.sd.extend(b'\xFF' * (end - len(s.sd)))
+            reply += b'\x00\x01'
+            if name == 'read_sector':
+                reply += s.sd[s.sd_address:end]
+            else:
+                s.sd[s.sd_address:end] = a
+            s.sd_address = end
+        elif name == 'flush_media':
+            reply += b'\x00\x01'
+        elif name == 'display_image':
+            if not s.display_image(signed(word(a, 0)), signed(word(a, 2))):
+                reply = bytearray(NAK)
+        # display_control, display_power, display_video and display_frame
+        # only get an ACK
+        return reply
+
+    def feed(self, data, split_on=None, on_frame=None):
+        for name, start, end in self.commands(data):
+            if split_on and name == split_on and self.frame_bytes:
+                on_frame()
+            cmd = data[start:end]
+            self.replies += self.run(name, cmd)
+            self.frame_bytes += len(cmd)
+            self.frame_commands[name] += 1
+            # start bit + 8 data + stop bit per byte
+            self.frame_seconds += 10.0 * len(cmd) / self.screen.baud
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('captures', nargs='+', help='files of bytes sent to the screen')
+    parser.add_argument('-o', '--output', default='.', help='directory for frame images')
+    parser.add_argument('--ppm', action='store_true', help='write PPM instead of PNG')
+    parser.add_argument('--split-on', help='start a new frame before each command of this name, e.g. locate or cls')
+    parser.add_argument('--baud', type=int, default=9600, help='baud rate at the start of the capture')
+    parser.add_argument('--sd', help='raw uSD card image for the media commands')
+    parser.add_argument('--replies', help='write the bytes the screen would send back to this file')
+    parser.add_argument('--sd-out', help='write the emulated uSD card to this file afterwards')
+    args = parser.parse_args()
+
+    sd = None
+    if args.sd:
+        with open(args.sd, 'rb') as f:
+            sd = bytearray(f.read())
+    screen = Screen(sd)
+    screen.baud = args.baud
+    emulator = Emulator(screen)
+    if not os.path.isdir(args.output):
+        os.makedirs(args.output)
+
+    frames = []
+
+    def end_frame():
+        index = len(frames)
+        path = os.path.join(args.output, 'frame%04d.%s' % (index, 'ppm' if args.ppm else 'png'))
+        if args.ppm:
+            screen.write_ppm(path)
+        else:
+            screen.write_png(path)
+        frames.append((path, emulator.frame_bytes, sum(emulator.frame_commands.values()),
+                       emulator.frame_seconds, emulator.frame_commands))
+        emulator.new_frame()
+
+    for capture in args.captures:
+        with open(capture, 'rb') as f:
+            data = bytearray(f.read())
+        try:
+            emulator.feed(data, args.split_on, end_frame)
+        except ValueError as e:
+            sys.exit('%s: %s' % (capture, e))
+        if emulator.frame_bytes or not args.split_on:
+            end_frame()
+
+    if args.sd_out:
+        with open(args.sd_out, 'wb') as f:
+            f.write(screen.sd)
+
+    if args.replies:
+        with open(args.replies, 'wb') as f:
+            f.write(emulator.replies)
+
+    total_bytes = 0
+    total_commands = 0
+    print('%-28s %8s %8s %9s  %s' % ('frame', 'bytes', 'commands', 'wire ms', 'by command'))
+    for path, nbytes, ncommands, seconds, counts in frames:
+        detail = ' '.join('%s=%d' % kv for kv in sorted(counts.items()))
+        print('%-28s %8d %8d %9.2f  %s' % (os.path.basename(path), nbytes, ncommands, 1000.0 * seconds, detail))
+        total_bytes += nbytes
+        total_commands += ncommands
+    print('%-28s %8d %8d' % ('total', total_bytes, total_commands))
+
+
+if __name__ == '__main__':
+    main()
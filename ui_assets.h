@@ -0,0 +1,44 @@
+// UI images on the uLCD microSD card, drawn with SdImages
+// Generated by tools/ui_assets.py, write ui_assets.img to the card with
+//   sudo dd if=ui_assets.img of=/dev/sdX bs=512 seek=32768
+
+const uint32_t kUiAssetSector  = 0x8000;
+const uint32_t kUiAssetBuildId = 0x9C9A2DFA;
+
+enum ui_asset
+   {kUiLabels,
+    kUiUserOff,
+    kUiUserCool,
+    kUiUserHeat,
+    kUiUserRunRadiatorPump,
+    kUiUserRunShirtPump,
+    kUiSystemOff,
+    kUiSystemPrecool,
+    kUiSystemPreheat,
+    kUiSystemCooling,
+    kUiSystemHeating,
+    kUiSystemCoolDown,
+    kUiSystemCoolCoast,
+    kUiSystemHeatUp,
+    kUiSystemHeatCoast,
+    kUiSystemRunRadiatorPump,
+    kUiSystemRunShirtPump,
+    kUiDigit0,
+    kUiDigit1,
+    kUiDigit2,
+    kUiDigit3,
+    kUiDigit4,
+    kUiDigit5,
+    kUiDigit6,
+    kUiDigit7,
+    kUiDigit8,
+    kUiDigit9,
+    kUiDigitPoint,
+    kUiDigitBlank,
+    kUiDigitMinus,
+    kUiDegreesC,
+    kUiAssetCount};
+
+// Setpoint digit size in pixels
+const int kUiDigitWidth  = 14;
+const int kUiDigitHeight = 16;